@@ -3,7 +3,7 @@ include(../version.pri)
 TEMPLATE = lib
 TARGET = ofono-qt
 
-CONFIG += debug
+CONFIG += debug c++11
 DEFINES += BUILD_OFONO_QT_LIBRARY
 
 QT += dbus
@@ -12,9 +12,21 @@ INCLUDEPATH += ../
 
 PUBLIC_HEADERS += libofono-qt_global.h \
     ofonopropertysetting.h  \
+    ofonopropertytrigger.h \
+    ofonopropertycallback.h \
+    ofonopropertysnapshot.h \
+    ofonoeventbus.h \
+    ofonoeventqueue.h \
+    ofonoiothread.h \
+    ofonoconnection.h \
+    ofonopathset.h \
+    ofonoservicetracker.h \
+    ofonopropertycache.h \
     ofonomodeminterface.h  \
     ofonomodemmanager.h \
+    ofonofederatedmodemmanager.h \
     ofonomodem.h \
+    ofonomodemhub.h \
     ofonophonebook.h \
     ofonomessagemanager.h \
     ofonomessagewaiting.h \
@@ -29,6 +41,14 @@ PUBLIC_HEADERS += libofono-qt_global.h \
     ofonosupplementaryservices.h \
     ofonovoicecallmanager.h \
     ofonovoicecall.h \
+    ofonocalltimeline.h \
+    ofonocdrrecord.h \
+    ofonocdrwriter.h \
+    ofonocdrreader.h \
+    ofonocallhistory.h \
+    ofonocallscheduler.h \
+    ofonoconference.h \
+    ofonocontactindex.h \
     ofonocallvolume.h \
     ofonomessage.h \
     ofonoconnman.h \
@@ -36,12 +56,26 @@ PUBLIC_HEADERS += libofono-qt_global.h \
     ofonocellbroadcast.h
 
 HEADERS += $$PUBLIC_HEADERS \
-    ofonointerface.h
+    ofonointerface.h \
+    ofonointerface_p.h \
+    ofonovoicecall_p.h \
+    ofonocdr_p.h
 
 SOURCES += ofonointerface.cpp \
+    ofonopropertytrigger.cpp \
+    ofonopropertysnapshot.cpp \
+    ofonoeventbus.cpp \
+    ofonoeventqueue.cpp \
+    ofonoiothread.cpp \
+    ofonoconnection.cpp \
+    ofonopathset.cpp \
+    ofonoservicetracker.cpp \
+    ofonopropertycache.cpp \
     ofonomodeminterface.cpp \
     ofonomodemmanager.cpp \
+    ofonofederatedmodemmanager.cpp \
     ofonomodem.cpp \
+    ofonomodemhub.cpp \
     ofonophonebook.cpp \
     ofonomessagemanager.cpp \
     ofonomessagewaiting.cpp \
@@ -56,6 +90,13 @@ SOURCES += ofonointerface.cpp \
     ofonosupplementaryservices.cpp \
     ofonovoicecallmanager.cpp \
     ofonovoicecall.cpp \
+    ofonocalltimeline.cpp \
+    ofonocdrwriter.cpp \
+    ofonocdrreader.cpp \
+    ofonocallhistory.cpp \
+    ofonocallscheduler.cpp \
+    ofonoconference.cpp \
+    ofonocontactindex.cpp \
     ofonocallvolume.cpp \
     ofonomessage.cpp \
     ofonoconnman.cpp \
@@ -30,6 +30,17 @@
 
 OfonoCallBarring::OfonoCallBarring(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.CallBarring", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+OfonoCallBarring::OfonoCallBarring(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.CallBarring", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+void OfonoCallBarring::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -61,12 +72,12 @@ void OfonoCallBarring::changePassword(const QString &old_password,
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "ChangePassword");
     request << old_password << new_password;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(changePasswordResp()),
 					SLOT(changePasswordErr(const QDBusError&)));
 }
@@ -75,12 +86,12 @@ void OfonoCallBarring::disableAll(const QString &password)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "DisableAll");
     request << password;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(disableAllResp()),
 					SLOT(disableAllErr(const QDBusError&)));
 }
@@ -89,12 +100,12 @@ void OfonoCallBarring::disableAllIncoming(const QString &password)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "DisableAllIncoming");
     request << password;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(disableAllIncomingResp()),
 					SLOT(disableAllIncomingErr(const QDBusError&)));
 }
@@ -103,12 +114,12 @@ void OfonoCallBarring::disableAllOutgoing(const QString &password)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "DisableAllOutgoing");
     request << password;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(disableAllOutgoingResp()),
 					SLOT(disableAllOutgoingErr(const QDBusError&)));
 }
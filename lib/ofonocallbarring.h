@@ -40,6 +40,8 @@ class OFONO_QT_EXPORT OfonoCallBarring : public OfonoModemInterface
 
 public:
     OfonoCallBarring(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoCallBarring(OfonoModem *modem, QObject *parent=0);
     ~OfonoCallBarring();
 
 public Q_SLOTS:
@@ -82,6 +84,7 @@ private Q_SLOTS:
     void disableAllOutgoingErr(QDBusError error);
     void requestPropertyComplete(bool success, const QString& property, const QVariant& value);
 private:
+    void init();
     void connectDbusSignals(const QString& path);
 };
 
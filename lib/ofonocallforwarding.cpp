@@ -29,6 +29,17 @@
 
 OfonoCallForwarding::OfonoCallForwarding(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.CallForwarding", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+OfonoCallForwarding::OfonoCallForwarding(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.CallForwarding", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+void OfonoCallForwarding::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -47,12 +58,12 @@ void OfonoCallForwarding::disableAll(const QString &type)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "DisableAll");
     request << type;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(disableAllResp()),
 					SLOT(disableAllErr(const QDBusError&)));
 }
@@ -40,6 +40,8 @@ class OFONO_QT_EXPORT OfonoCallForwarding : public OfonoModemInterface
 
 public:
     OfonoCallForwarding(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoCallForwarding(OfonoModem *modem, QObject *parent=0);
     ~OfonoCallForwarding();
 
 public Q_SLOTS:
@@ -89,6 +91,9 @@ private Q_SLOTS:
       
     void disableAllResp();
     void disableAllErr(QDBusError error);
+
+private:
+    void init();
 };
 
 #endif  /* !OFONOCALLFORWARDING_H */
@@ -0,0 +1,235 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtCore/QObject>
+#include <QDataStream>
+#include <QDateTime>
+#include <algorithm>
+
+#include "ofonocallhistory.h"
+#include "ofonovoicecallmanager.h"
+#include "ofonovoicecall.h"
+
+#define CALLHISTORY_MAGIC 0x5348434f   // "OCHS"
+#define CALLHISTORY_VERSION 1
+
+OfonoCallHistory::OfonoCallHistory(OfonoVoiceCallManager *manager, QObject *parent)
+    : QObject(parent), m_manager(manager)
+{
+    if (m_manager) {
+        connect(m_manager, SIGNAL(callAdded(const QString&, const QVariantMap&)),
+                this, SLOT(callAdded(const QString&, const QVariantMap&)));
+        connect(m_manager, SIGNAL(callRemoved(const QString&)),
+                this, SLOT(callRemoved(const QString&)));
+    }
+}
+
+OfonoCallHistory::~OfonoCallHistory()
+{
+    close();
+}
+
+bool OfonoCallHistory::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite))
+        return false;
+
+    QDataStream stream(&m_file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    if (m_file.size() == 0) {
+        stream << quint32(CALLHISTORY_MAGIC) << quint16(CALLHISTORY_VERSION);
+        m_file.flush();
+        return true;
+    }
+
+    quint32 magic;
+    quint16 version;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != CALLHISTORY_MAGIC
+        || version != CALLHISTORY_VERSION) {
+        m_file.close();
+        return false;
+    }
+
+    qint64 good = m_file.pos();
+    while (!stream.atEnd()) {
+        OfonoCallHistoryEntry entry;
+        quint8 direction, answered;
+        stream >> entry.number >> entry.time >> entry.duration >> direction >> answered;
+        // a record that is not ours is dropped like a partly written one
+        if (stream.status() != QDataStream::Ok || direction > OfonoCallHistoryEntry::Outgoing)
+            break;
+        entry.direction = OfonoCallHistoryEntry::Direction(direction);
+        entry.answered = answered;
+        insert(entry);
+        good = m_file.pos();
+    }
+    // drop a record that was only partly written, and anything after it
+    if (good < m_file.size())
+        m_file.resize(good);
+    m_file.seek(good);
+    return true;
+}
+
+void OfonoCallHistory::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+    m_entries.clear();
+    m_byTime.clear();
+    m_byDirection[0].clear();
+    m_byDirection[1].clear();
+    m_missed.clear();
+    m_byNumber.clear();
+}
+
+void OfonoCallHistory::add(const OfonoCallHistoryEntry &added)
+{
+    if (added.direction != OfonoCallHistoryEntry::Incoming
+        && added.direction != OfonoCallHistoryEntry::Outgoing)
+        return;
+    OfonoCallHistoryEntry entry = added;
+    entry.number = normalizeNumber(entry.number);
+    if (m_file.isOpen()) {
+        QDataStream stream(&m_file);
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream << entry.number << entry.time << entry.duration
+               << quint8(entry.direction) << quint8(entry.answered);
+        m_file.flush();
+    }
+    insert(entry);
+    emit entryAdded(entry);
+}
+
+void OfonoCallHistory::insert(const OfonoCallHistoryEntry &entry)
+{
+    int id = m_entries.count();
+    m_entries.append(entry);
+
+    indexEntry(m_byTime, id);
+    indexEntry(m_byDirection[entry.direction], id);
+    if (entry.isMissed())
+        indexEntry(m_missed, id);
+    indexEntry(m_byNumber[entry.number], id);
+}
+
+void OfonoCallHistory::indexEntry(Index &index, int id)
+{
+    // entries are added when calls end, so they mostly arrive in order
+    qint64 time = m_entries.at(id).time;
+    int pos = index.count();
+    while (pos > 0 && m_entries.at(index.at(pos - 1)).time > time)
+        --pos;
+    index.insert(pos, id);
+}
+
+OfonoCallHistory::Index::const_iterator OfonoCallHistory::since(const Index &index, qint64 time) const
+{
+    return std::lower_bound(index.constBegin(), index.constEnd(), time,
+                            [this](int id, qint64 t) {return m_entries.at(id).time < t;});
+}
+
+QList<OfonoCallHistoryEntry> OfonoCallHistory::entries(Index::const_iterator begin, Index::const_iterator end) const
+{
+    QList<OfonoCallHistoryEntry> result;
+    result.reserve(end - begin);
+    for (Index::const_iterator i = begin; i != end; ++i)
+        result.append(m_entries.at(*i));
+    return result;
+}
+
+QList<OfonoCallHistoryEntry> OfonoCallHistory::lastCalls(const QString &number, int n) const
+{
+    QHash<QString, Index>::const_iterator i = m_byNumber.constFind(normalizeNumber(number));
+    if (i == m_byNumber.constEnd() || n <= 0)
+        return QList<OfonoCallHistoryEntry>();
+    const Index &index = i.value();
+    return entries(index.constEnd() - qMin(n, index.count()), index.constEnd());
+}
+
+QList<OfonoCallHistoryEntry> OfonoCallHistory::calls(qint64 time) const
+{
+    return entries(since(m_byTime, time), m_byTime.constEnd());
+}
+
+QList<OfonoCallHistoryEntry> OfonoCallHistory::calls(OfonoCallHistoryEntry::Direction direction, qint64 time) const
+{
+    if (direction != OfonoCallHistoryEntry::Incoming && direction != OfonoCallHistoryEntry::Outgoing)
+        return QList<OfonoCallHistoryEntry>();
+    const Index &index = m_byDirection[direction];
+    return entries(since(index, time), index.constEnd());
+}
+
+QList<OfonoCallHistoryEntry> OfonoCallHistory::missedCalls(qint64 time) const
+{
+    return entries(since(m_missed, time), m_missed.constEnd());
+}
+
+QString OfonoCallHistory::normalizeNumber(const QString &number)
+{
+    QString result;
+    result.reserve(number.length());
+    foreach (QChar c, number) {
+        if (c.isDigit() || c == '*' || c == '#' || (c == '+' && result.isEmpty()))
+            result.append(c);
+    }
+    if (result.startsWith("00"))
+        result = '+' + result.mid(2);
+    return result;
+}
+
+void OfonoCallHistory::callAdded(const QString &path, const QVariantMap &values)
+{
+    OfonoCallHistoryEntry entry;
+    QString state = values["State"].value<QString>();
+    entry.direction = (state == "incoming" || state == "waiting")
+                      ? OfonoCallHistoryEntry::Incoming : OfonoCallHistoryEntry::Outgoing;
+    entry.number = values["LineIdentification"].value<QString>();
+    entry.time = QDateTime::currentMSecsSinceEpoch();
+    entry.duration = 0;
+    entry.answered = false;
+    m_pending.insert(path, entry);
+}
+
+void OfonoCallHistory::callRemoved(const QString &path)
+{
+    if (!m_pending.contains(path))
+        return;
+    OfonoCallHistoryEntry entry = m_pending.take(path);
+
+    // the manager deletes its call object only after callRemoved()
+    OfonoVoiceCall *call = m_manager ? m_manager->call(path) : 0;
+    if (call) {
+        qint64 answerTime = call->timeline().answerTime();
+        if (answerTime >= 0) {
+            entry.answered = true;
+            entry.duration = QDateTime::currentMSecsSinceEpoch() - entry.time - answerTime;
+        }
+        if (!call->lineIdentification().isEmpty())
+            entry.number = call->lineIdentification();
+    }
+    add(entry);
+}
@@ -0,0 +1,126 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCALLHISTORY_H
+#define OFONOCALLHISTORY_H
+
+#include <QtCore/QObject>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QPointer>
+#include <QVariant>
+
+#include "libofono-qt_global.h"
+
+class OfonoVoiceCallManager;
+
+//! One call in OfonoCallHistory
+struct OfonoCallHistoryEntry
+{
+    enum Direction {Incoming, Outgoing};
+
+    QString number;     //!< normalized, see OfonoCallHistory::normalizeNumber()
+    qint64 time;        //!< when the call appeared, in msecs since the epoch (UTC)
+    qint32 duration;    //!< msecs the call was active, 0 if it never was
+    Direction direction;
+    bool answered;
+
+    bool isMissed() const {return direction == Incoming && !answered;}
+};
+
+//! Keeps a history of the calls of a modem
+/*!
+ * oFono has no call history of its own, so the history is built from the
+ * callAdded() and callRemoved() signals of an OfonoVoiceCallManager and the
+ * call objects it keeps. Entries are appended to a file, which is read back
+ * by open(); a record left incomplete by a crash is dropped.
+ *
+ * All entries are also held in memory and indexed by number, by direction
+ * and by time, so the queries below do not scan the history. The returned
+ * entries are ordered by time, oldest first.
+ */
+class OFONO_QT_EXPORT OfonoCallHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OfonoCallHistory(OfonoVoiceCallManager *manager, QObject *parent=0);
+    ~OfonoCallHistory();
+
+    //! Reads the history from a file and appends new entries to it
+    /*!
+     * Returns false if the file cannot be opened or is not a history file.
+     */
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const {return m_file.isOpen();}
+
+    //! Adds an entry; it is written to the file if one is open
+    /*!
+     * The number of the entry is normalized first. Entries with an invalid
+     * direction are ignored.
+     */
+    void add(const OfonoCallHistoryEntry &entry);
+
+    int count() const {return m_entries.count();}
+    const OfonoCallHistoryEntry &at(int i) const {return m_entries.at(i);}
+
+    //! Returns the last \a n calls to or from a number
+    QList<OfonoCallHistoryEntry> lastCalls(const QString &number, int n) const;
+    //! Returns the calls that appeared at or after \a since
+    QList<OfonoCallHistoryEntry> calls(qint64 since) const;
+    //! Returns the calls in one direction that appeared at or after \a since
+    QList<OfonoCallHistoryEntry> calls(OfonoCallHistoryEntry::Direction direction, qint64 since) const;
+    //! Returns the missed calls that appeared at or after \a since
+    QList<OfonoCallHistoryEntry> missedCalls(qint64 since) const;
+
+    //! Returns the number without separators, with "00" turned into "+"
+    static QString normalizeNumber(const QString &number);
+
+Q_SIGNALS:
+    void entryAdded(const OfonoCallHistoryEntry &entry);
+
+private Q_SLOTS:
+    void callAdded(const QString &path, const QVariantMap &values);
+    void callRemoved(const QString &path);
+
+private:
+    typedef QVector<int> Index;
+
+    void insert(const OfonoCallHistoryEntry &entry);
+    void indexEntry(Index &index, int id);
+    Index::const_iterator since(const Index &index, qint64 time) const;
+    QList<OfonoCallHistoryEntry> entries(Index::const_iterator begin, Index::const_iterator end) const;
+
+    QPointer<OfonoVoiceCallManager> m_manager;
+    QHash<QString, OfonoCallHistoryEntry> m_pending;
+    QFile m_file;
+    QVector<OfonoCallHistoryEntry> m_entries;
+    Index m_byTime;
+    Index m_byDirection[2];
+    Index m_missed;
+    QHash<QString, Index> m_byNumber;
+};
+
+#endif // OFONOCALLHISTORY_H
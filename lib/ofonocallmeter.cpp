@@ -29,6 +29,17 @@
 
 OfonoCallMeter::OfonoCallMeter(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.CallMeter", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+OfonoCallMeter::OfonoCallMeter(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.CallMeter", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+void OfonoCallMeter::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -39,6 +39,8 @@ class OFONO_QT_EXPORT OfonoCallMeter : public OfonoModemInterface
 
 public:
     OfonoCallMeter(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoCallMeter(OfonoModem *modem, QObject *parent=0);
     ~OfonoCallMeter();
 
 public Q_SLOTS:
@@ -53,6 +55,9 @@ Q_SIGNALS:
 private Q_SLOTS:
     void propertyChanged(const QString& property, const QVariant& value);
     void requestPropertyComplete(bool success, const QString& property, const QVariant& value);
+
+private:
+    void init();
 };
 
 #endif  /* !OFONOCALLMETER_H */
@@ -0,0 +1,162 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtCore/QObject>
+#include <QDBusPendingCallWatcher>
+#include <QDBusError>
+
+#include "ofonocallscheduler.h"
+
+OfonoCallScheduler::OfonoCallScheduler(QObject *parent)
+    : QObject(parent), m_currentLane(ControlLane), m_watcher(0)
+{
+    m_clock.start();
+    resetStats();
+}
+
+OfonoCallScheduler::~OfonoCallScheduler()
+{
+}
+
+void OfonoCallScheduler::schedule(Lane lane, const Start &start, const Finish &finish)
+{
+    Operation operation;
+    operation.start = start;
+    operation.finish = finish;
+    operation.queuedAt = now();
+    m_lanes[lane].enqueue(operation);
+    sendNext();
+}
+
+void OfonoCallScheduler::schedule(Lane lane, const QDBusConnection &bus, const QDBusMessage &request,
+                                  int timeout, const Finish &finish)
+{
+    QDBusConnection connection = bus;
+    schedule(lane, [connection, request, timeout]() {
+        return connection.asyncCall(request, timeout);
+    }, finish);
+}
+
+QDBusPendingCall OfonoCallScheduler::execute(Lane lane, const Start &start)
+{
+    QList<QDBusPendingCall> replies;
+    schedule(lane, start, [&replies](const QDBusPendingCall &call) {
+        replies << call;
+    });
+    // waiting for the watcher delivers its finished() signal, which sends
+    // the next operation, until it is the turn of this one
+    while (replies.isEmpty() && m_watcher)
+        m_watcher->waitForFinished();
+    if (replies.isEmpty())
+        return QDBusPendingCall::fromError(QDBusError(QDBusError::Other, "Operation cancelled"));
+    return replies.first();
+}
+
+int OfonoCallScheduler::cancel(Lane lane)
+{
+    QQueue<Operation> cancelled;
+    cancelled.swap(m_lanes[lane]);
+    m_stats[lane].cancelled += cancelled.count();
+
+    QDBusPendingCall error = QDBusPendingCall::fromError(QDBusError(QDBusError::Other, "Operation cancelled"));
+    foreach (const Operation &operation, cancelled) {
+        if (operation.finish)
+            operation.finish(error);
+    }
+    return cancelled.count();
+}
+
+void OfonoCallScheduler::recordSynchronous(Lane lane, qint64 usecs, bool success)
+{
+    LaneStats &stats = m_stats[lane];
+    if (success)
+        stats.completed++;
+    else
+        stats.failed++;
+    stats.totalLatency += usecs;
+    stats.maxLatency = qMax(stats.maxLatency, usecs);
+}
+
+void OfonoCallScheduler::resetStats()
+{
+    for (int i = 0; i < LaneCount; i++) {
+        LaneStats &stats = m_stats[i];
+        stats.completed = stats.failed = stats.cancelled = stats.overtaken = 0;
+        stats.totalWait = stats.maxWait = 0;
+        stats.totalLatency = stats.maxLatency = 0;
+    }
+}
+
+void OfonoCallScheduler::sendNext()
+{
+    if (m_watcher)
+        return;
+
+    int lane = 0;
+    while (lane < LaneCount && m_lanes[lane].isEmpty())
+        lane++;
+    if (lane == LaneCount)
+        return;
+
+    m_currentLane = Lane(lane);
+    m_current = m_lanes[lane].dequeue();
+    for (int i = lane + 1; i < LaneCount; i++) {
+        foreach (const Operation &waiting, m_lanes[i]) {
+            if (waiting.queuedAt < m_current.queuedAt)
+                m_stats[i].overtaken++;
+        }
+    }
+
+    qint64 wait = now() - m_current.queuedAt;
+    LaneStats &stats = m_stats[lane];
+    stats.totalWait += wait;
+    stats.maxWait = qMax(stats.maxWait, wait);
+
+    m_watcher = new QDBusPendingCallWatcher(m_current.start(), this);
+    connect(m_watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(finished(QDBusPendingCallWatcher*)));
+}
+
+void OfonoCallScheduler::finished(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    if (watcher != m_watcher)
+        return;
+    m_watcher = 0;
+
+    LaneStats &stats = m_stats[m_currentLane];
+    qint64 latency = now() - m_current.queuedAt;
+    stats.totalLatency += latency;
+    stats.maxLatency = qMax(stats.maxLatency, latency);
+    if (watcher->isError())
+        stats.failed++;
+    else
+        stats.completed++;
+
+    // the handler may schedule the next operation of its own sequence
+    Finish finish = m_current.finish;
+    m_current = Operation();
+    if (finish)
+        finish(*watcher);
+    sendNext();
+}
@@ -0,0 +1,144 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCALLSCHEDULER_H
+#define OFONOCALLSCHEDULER_H
+
+#include <functional>
+#include <QtCore/QObject>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+
+#include "libofono-qt_global.h"
+
+class QDBusPendingCallWatcher;
+
+//! Sends voice call operations to oFono one at a time, most urgent first
+/*!
+ * oFono refuses most voice call manager requests while another one is in
+ * progress, so OfonoVoiceCallManager passes its asynchronous operations
+ * through a scheduler instead of firing them in caller order. Operations
+ * wait in one of several lanes; when the operation in flight completes, the
+ * oldest operation of the most urgent non-empty lane is sent next. An
+ * operation that has been sent is never interrupted, but tones are sent in
+ * short chunks, so a hangup queued behind a long tone sequence only waits
+ * for the chunk in flight. An emergency call goes ahead of everything that
+ * is queued, and the operations it passes stay queued.
+ *
+ * Every lane keeps statistics on how long its operations waited before they
+ * were sent and how long they took in total. Times are in microseconds.
+ */
+class OFONO_QT_EXPORT OfonoCallScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! The lanes, most urgent first
+    enum Lane {
+        EmergencyLane,  //!< dialing an emergency number
+        ControlLane,    //!< dialing, hangup, answer, hold, swap and transfer
+        MultipartyLane, //!< multiparty operations
+        ToneLane,       //!< DTMF tones
+        LaneCount
+    };
+
+    struct LaneStats {
+        quint64 completed;  //!< operations that succeeded
+        quint64 failed;     //!< operations that failed
+        quint64 cancelled;  //!< operations dropped before they were sent
+        quint64 overtaken;  //!< times a queued operation was passed by a more urgent one
+        qint64 totalWait;
+        qint64 maxWait;
+        qint64 totalLatency;
+        qint64 maxLatency;
+
+        //! Average time from scheduling to sending
+        qint64 averageWait() const {return completed + failed ? totalWait / qint64(completed + failed) : 0;}
+        //! Average time from scheduling to the reply
+        qint64 averageLatency() const {return completed + failed ? totalLatency / qint64(completed + failed) : 0;}
+    };
+
+    //! Sends an operation and returns the pending reply
+    typedef std::function<QDBusPendingCall()> Start;
+    //! Handles the reply of an operation, or its error
+    typedef std::function<void(const QDBusPendingCall &)> Finish;
+
+    explicit OfonoCallScheduler(QObject *parent=0);
+    ~OfonoCallScheduler();
+
+    //! Queues an operation; it is sent right away if nothing is in flight
+    void schedule(Lane lane, const Start &start, const Finish &finish);
+    //! Queues a D-Bus method call
+    void schedule(Lane lane, const QDBusConnection &bus, const QDBusMessage &request,
+                  int timeout, const Finish &finish);
+
+    //! Queues an operation and blocks until its reply has arrived
+    /*!
+     * The operations ahead of it are sent meanwhile and their handlers are
+     * called. The reply is an error if the lane is cancelled before the
+     * operation is sent. This is meant for keeping synchronous methods.
+     */
+    QDBusPendingCall execute(Lane lane, const Start &start);
+
+    //! Drops the queued operations of a lane and returns how many there were
+    /*!
+     * The handlers of the dropped operations are called with an error.
+     */
+    int cancel(Lane lane);
+
+    //! Returns the number of operations queued in a lane, not counting the one in flight
+    int pending(Lane lane) const {return m_lanes[lane].count();}
+    //! Returns true while an operation is in flight
+    bool isBusy() const {return m_watcher != 0;}
+
+    //! Accounts an operation that was carried out outside the lanes
+    void recordSynchronous(Lane lane, qint64 usecs, bool success);
+
+    LaneStats stats(Lane lane) const {return m_stats[lane];}
+    void resetStats();
+
+private Q_SLOTS:
+    void finished(QDBusPendingCallWatcher *watcher);
+
+private:
+    struct Operation {
+        Start start;
+        Finish finish;
+        qint64 queuedAt;
+    };
+
+    void sendNext();
+    qint64 now() const {return m_clock.nsecsElapsed() / 1000;}
+
+    QQueue<Operation> m_lanes[LaneCount];
+    LaneStats m_stats[LaneCount];
+    Operation m_current;
+    Lane m_currentLane;
+    QDBusPendingCallWatcher *m_watcher;
+    QElapsedTimer m_clock;
+};
+
+#endif // OFONOCALLSCHEDULER_H
@@ -29,6 +29,17 @@
 
 OfonoCallSettings::OfonoCallSettings(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.CallSettings", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+OfonoCallSettings::OfonoCallSettings(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.CallSettings", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+void OfonoCallSettings::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
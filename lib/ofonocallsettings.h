@@ -39,6 +39,8 @@ class OFONO_QT_EXPORT OfonoCallSettings : public OfonoModemInterface
 
 public:
     OfonoCallSettings(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoCallSettings(OfonoModem *modem, QObject *parent=0);
     ~OfonoCallSettings();
 
 public Q_SLOTS:
@@ -80,6 +82,9 @@ private Q_SLOTS:
     void propertyChanged(const QString& property, const QVariant& value);
     void setPropertyFailed(const QString& property);
     void requestPropertyComplete(bool success, const QString& property, const QVariant& value);      
+
+private:
+    void init();
 };
 
 #endif  /* !OFONOCALLSETTINGS_H */
@@ -0,0 +1,138 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QElapsedTimer>
+
+#include "ofonocalltimeline.h"
+
+static const char * const stateNames[] = {
+    "", "incoming", "waiting", "dialing", "alerting", "active", "held", "disconnected"
+};
+
+OfonoCallTimeline::OfonoCallTimeline()
+    : m_first(0), m_count(0), m_recorded(0), m_state(UnknownState),
+      m_setupAt(-1), m_dialingAt(-1), m_alertingAt(-1), m_activeAt(-1),
+      m_heldAt(-1), m_heldTotal(0), m_disconnectReasonAt(-1)
+{
+}
+
+qint64 OfonoCallTimeline::now()
+{
+    static const QElapsedTimer clock = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+OfonoCallTimeline::State OfonoCallTimeline::stateFromString(const QString &state)
+{
+    for (int i = IncomingState; i <= DisconnectedState; i++)
+        if (state == QLatin1String(stateNames[i]))
+            return State(i);
+    return UnknownState;
+}
+
+QString OfonoCallTimeline::stateName(State state)
+{
+    return QLatin1String(stateNames[state]);
+}
+
+void OfonoCallTimeline::record(State state, qint64 timestamp)
+{
+    if (state == m_state)
+        return;
+
+    Event &event = m_events[(m_first + m_count) % Capacity];
+    if (m_count == Capacity)
+        m_first = (m_first + 1) % Capacity;
+    else
+        m_count++;
+    event.state = state;
+    event.timestamp = timestamp;
+    m_recorded++;
+
+    if (m_state == HeldState && m_heldAt >= 0) {
+        m_heldTotal += timestamp - m_heldAt;
+        m_heldAt = -1;
+    }
+
+    switch (state) {
+    case IncomingState:
+    case WaitingState:
+        if (m_setupAt < 0)
+            m_setupAt = timestamp;
+        break;
+    case DialingState:
+        if (m_dialingAt < 0)
+            m_dialingAt = timestamp;
+        if (m_setupAt < 0)
+            m_setupAt = timestamp;
+        break;
+    case AlertingState:
+        if (m_alertingAt < 0)
+            m_alertingAt = timestamp;
+        if (m_setupAt < 0)
+            m_setupAt = timestamp;
+        break;
+    case ActiveState:
+        if (m_activeAt < 0)
+            m_activeAt = timestamp;
+        break;
+    case HeldState:
+        m_heldAt = timestamp;
+        break;
+    default:
+        break;
+    }
+    m_state = state;
+}
+
+void OfonoCallTimeline::recordDisconnectReason(const QString &reason, qint64 timestamp)
+{
+    m_disconnectReason = reason;
+    m_disconnectReasonAt = timestamp;
+}
+
+qint64 OfonoCallTimeline::postDialDelay() const
+{
+    if (m_dialingAt < 0 || m_alertingAt < 0)
+        return -1;
+    return (m_alertingAt - m_dialingAt) / 1000000;
+}
+
+qint64 OfonoCallTimeline::answerTime() const
+{
+    if (m_setupAt < 0 || m_activeAt < 0)
+        return -1;
+    return (m_activeAt - m_setupAt) / 1000000;
+}
+
+qint64 OfonoCallTimeline::holdTime() const
+{
+    qint64 total = m_heldTotal;
+    if (m_heldAt >= 0)
+        total += now() - m_heldAt;
+    return total / 1000000;
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCALLTIMELINE_H
+#define OFONOCALLTIMELINE_H
+
+#include <QString>
+#include "libofono-qt_global.h"
+
+//! Records the state transitions of one voice call
+/*!
+ * Every OfonoVoiceCall keeps a timeline, see OfonoVoiceCall::timeline().
+ * Transitions are stored with monotonic timestamps in a fixed ring of
+ * Capacity events that is allocated with the timeline, so recording never
+ * allocates; when the ring is full the oldest event is overwritten. The
+ * derived metrics are updated as events are recorded and stay correct after
+ * the ring has wrapped.
+ *
+ * Timestamps are in nanoseconds on the clock returned by now(). The metrics
+ * are in milliseconds; postDialDelay() and answerTime() are -1 until both
+ * transitions they measure have been seen.
+ */
+class OFONO_QT_EXPORT OfonoCallTimeline
+{
+public:
+    enum State {
+        UnknownState,
+        IncomingState,
+        WaitingState,
+        DialingState,
+        AlertingState,
+        ActiveState,
+        HeldState,
+        DisconnectedState
+    };
+
+    enum { Capacity = 16 };
+
+    struct Event {
+        State state;
+        qint64 timestamp;
+    };
+
+    OfonoCallTimeline();
+
+    //! Returns the current time of the monotonic clock used for timestamps
+    static qint64 now();
+
+    //! Converts an oFono call state ("incoming", "active", ...) to State
+    static State stateFromString(const QString &state);
+    //! Converts State to the oFono call state string
+    static QString stateName(State state);
+
+    //! Records a transition; repeating the current state is ignored
+    void record(State state, qint64 timestamp = now());
+    void record(const QString &state, qint64 timestamp = now()) {record(stateFromString(state), timestamp);}
+    //! Records the reason oFono gave for disconnecting the call
+    void recordDisconnectReason(const QString &reason, qint64 timestamp = now());
+
+    //! Returns the number of events held in the ring
+    int count() const {return m_count;}
+    //! Returns an event, 0 being the oldest one still held
+    Event at(int i) const {return m_events[(m_first + i) % Capacity];}
+    //! Returns the total number of events recorded, including overwritten ones
+    int recorded() const {return m_recorded;}
+
+    State state() const {return m_state;}
+    QString disconnectReason() const {return m_disconnectReason;}
+    qint64 disconnectReasonTimestamp() const {return m_disconnectReasonAt;}
+
+    //! Returns the time from dialing until the remote party was alerted
+    qint64 postDialDelay() const;
+    //! Returns the time from dialing or ringing until the call became active
+    qint64 answerTime() const;
+    //! Returns the total time the call spent held, up to now if it still is
+    qint64 holdTime() const;
+
+private:
+    Event m_events[Capacity];
+    int m_first;
+    int m_count;
+    int m_recorded;
+    State m_state;
+    qint64 m_setupAt;
+    qint64 m_dialingAt;
+    qint64 m_alertingAt;
+    qint64 m_activeAt;
+    qint64 m_heldAt;
+    qint64 m_heldTotal;
+    QString m_disconnectReason;
+    qint64 m_disconnectReasonAt;
+};
+
+#endif // OFONOCALLTIMELINE_H
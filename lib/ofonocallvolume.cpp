@@ -29,13 +29,23 @@
 
 OfonoCallVolume::OfonoCallVolume(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.CallVolume", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoCallVolume::OfonoCallVolume(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.CallVolume", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoCallVolume::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
 
     connect(m_if, SIGNAL(setPropertyFailed(const QString&)),
             this, SLOT(setPropertyFailed(const QString&)));
-
 }
 
 OfonoCallVolume::~OfonoCallVolume()
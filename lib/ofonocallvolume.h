@@ -43,6 +43,8 @@ class OFONO_QT_EXPORT OfonoCallVolume : public OfonoModemInterface
     
 public:
     OfonoCallVolume(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoCallVolume(OfonoModem *modem, QObject *parent=0);
     ~OfonoCallVolume();
 
     /* Properties */
@@ -67,6 +69,9 @@ private Q_SLOTS:
     void propertyChanged(const QString& property, const QVariant& value);
     void setPropertyFailed(const QString& property);
 
+
+private:
+    void init();
 };
 
 #endif // OFONOCALLVOLUME_H
@@ -0,0 +1,53 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCDR_P_H
+#define OFONOCDR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the ofono-qt API. It may change from version
+// to version without notice, or even be removed.
+//
+
+#include <QtGlobal>
+
+#define OFONO_CDR_MAGIC 0x5244434f   // "OCDR"
+#define OFONO_CDR_VERSION 1
+
+//! Header at the start of a call detail record file
+struct OfonoCdrFileHeader
+{
+    quint32 magic;
+    quint16 version;
+    quint16 recordSize;
+    // written after the record it accounts for
+    qint64 count;
+    quint8 reserved[16];
+};
+
+Q_STATIC_ASSERT(sizeof(OfonoCdrFileHeader) == 32);
+
+#endif // OFONOCDR_P_H
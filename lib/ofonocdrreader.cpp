@@ -0,0 +1,92 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <string.h>
+
+#include "ofonocdrreader.h"
+#include "ofonocdr_p.h"
+
+OfonoCdrReader::OfonoCdrReader()
+    : m_map(0), m_capacity(0)
+{
+}
+
+OfonoCdrReader::~OfonoCdrReader()
+{
+    close();
+}
+
+bool OfonoCdrReader::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+    qint64 size = m_file.size();
+    if (size < (qint64)sizeof(OfonoCdrFileHeader)) {
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, size);
+    if (!m_map) {
+        m_file.close();
+        return false;
+    }
+
+    const OfonoCdrFileHeader *header = (const OfonoCdrFileHeader *)m_map;
+    if (header->magic != OFONO_CDR_MAGIC || header->version != OFONO_CDR_VERSION
+        || header->recordSize != sizeof(OfonoCdrRecord)) {
+        close();
+        return false;
+    }
+    m_capacity = (size - (qint64)sizeof(OfonoCdrFileHeader)) / sizeof(OfonoCdrRecord);
+    return true;
+}
+
+void OfonoCdrReader::close()
+{
+    if (m_map) {
+        m_file.unmap(const_cast<uchar *>(m_map));
+        m_map = 0;
+    }
+    m_capacity = 0;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+qint64 OfonoCdrReader::count() const
+{
+    if (!m_map)
+        return 0;
+    return qMin(((const OfonoCdrFileHeader *)m_map)->count, m_capacity);
+}
+
+OfonoCdrRecord OfonoCdrReader::at(qint64 i) const
+{
+    OfonoCdrRecord record;
+    Q_ASSERT(i >= 0 && i < count());
+    memcpy(&record, m_map + sizeof(OfonoCdrFileHeader) + i * sizeof(OfonoCdrRecord),
+           sizeof(record));
+    return record;
+}
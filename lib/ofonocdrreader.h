@@ -0,0 +1,62 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCDRREADER_H
+#define OFONOCDRREADER_H
+
+#include <QFile>
+
+#include "ofonocdrrecord.h"
+#include "libofono-qt_global.h"
+
+//! Reads a file written by OfonoCdrWriter
+/*!
+ * The file is memory-mapped read-only. Records appended by a writer after
+ * open() become visible as long as they fit in the part of the file that
+ * was mapped; call open() again to see the rest.
+ */
+class OFONO_QT_EXPORT OfonoCdrReader
+{
+public:
+    OfonoCdrReader();
+    ~OfonoCdrReader();
+
+    //! Returns false if the file cannot be opened or is not a record file
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const {return m_map != 0;}
+
+    //! Returns the number of readable records
+    qint64 count() const;
+    //! Returns a record, 0 being the oldest one
+    OfonoCdrRecord at(qint64 i) const;
+
+private:
+    Q_DISABLE_COPY(OfonoCdrReader)
+
+    QFile m_file;
+    const uchar *m_map;
+    qint64 m_capacity;
+};
+
+#endif // OFONOCDRREADER_H
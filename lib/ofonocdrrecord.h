@@ -0,0 +1,61 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCDRRECORD_H
+#define OFONOCDRRECORD_H
+
+#include <QtGlobal>
+
+//! One call detail record, as stored by OfonoCdrWriter
+/*!
+ * Records have a fixed size and layout so they can be read straight out of
+ * the memory-mapped file. Times are in milliseconds; wall clock times are
+ * counted from the Unix epoch in UTC. Strings are Latin-1 and padded with
+ * NUL characters.
+ */
+struct OfonoCdrRecord
+{
+    enum Direction {UnknownDirection, Incoming, Outgoing};
+    enum Technology {UnknownTechnology, Gsm, Edge, Umts, Hspa, Lte, Gprs, Hsdpa, Hsupa};
+    enum DisconnectReason {UnknownReason, LocalReason, RemoteReason, NetworkReason};
+    enum Flag {Answered = 0x01, Emergency = 0x02, Multiparty = 0x04};
+
+    qint64 addedAt;         //!< wall clock time the call appeared
+    qint64 startTime;       //!< wall clock time the call became active, or -1
+    qint64 removedAt;       //!< wall clock time the call went away
+    qint32 answerTime;      //!< see OfonoCallTimeline::answerTime()
+    qint32 postDialDelay;   //!< see OfonoCallTimeline::postDialDelay()
+    qint32 holdTime;        //!< see OfonoCallTimeline::holdTime()
+    quint32 cellId;         //!< cell the modem was registered in when the call appeared
+    quint16 locationAreaCode;
+    quint8 direction;       //!< Direction
+    quint8 technology;      //!< Technology of the registration
+    quint8 disconnectReason; //!< DisconnectReason
+    quint8 flags;           //!< Flag values
+    quint8 reserved[2];
+    char number[40];        //!< LineIdentification
+};
+
+Q_STATIC_ASSERT(sizeof(OfonoCdrRecord) == 88);
+
+#endif // OFONOCDRRECORD_H
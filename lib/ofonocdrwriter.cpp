@@ -0,0 +1,294 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtCore/QObject>
+#include <QDateTime>
+#include <QTimer>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "ofonocdrwriter.h"
+#include "ofonocdr_p.h"
+#include "ofonovoicecallmanager.h"
+#include "ofonovoicecall.h"
+#include "ofononetworkregistration.h"
+
+#define CDR_SYNC_INTERVAL 5000
+
+OfonoCdrWriter::OfonoCdrWriter(OfonoVoiceCallManager *manager, OfonoNetworkRegistration *registration, QObject *parent)
+    : QObject(parent), m_manager(manager), m_registration(registration), m_map(0),
+      m_capacity(0), m_synced(0), m_syncInterval(CDR_SYNC_INTERVAL)
+{
+    m_syncTimer = new QTimer(this);
+    connect(m_syncTimer, SIGNAL(timeout()), this, SLOT(sync()));
+
+    if (m_manager) {
+        connect(m_manager, SIGNAL(callAdded(const QString&, const QVariantMap&)),
+                this, SLOT(callAdded(const QString&, const QVariantMap&)));
+        connect(m_manager, SIGNAL(callRemoved(const QString&)),
+                this, SLOT(callRemoved(const QString&)));
+    }
+}
+
+OfonoCdrWriter::~OfonoCdrWriter()
+{
+    close();
+}
+
+bool OfonoCdrWriter::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite))
+        return false;
+
+    qint64 capacity;
+    if (m_file.size() == 0) {
+        OfonoCdrFileHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = OFONO_CDR_MAGIC;
+        header.version = OFONO_CDR_VERSION;
+        header.recordSize = sizeof(OfonoCdrRecord);
+        if (m_file.write((const char *)&header, sizeof(header)) != sizeof(header)) {
+            m_file.close();
+            return false;
+        }
+        capacity = GrowRecords;
+    } else if (m_file.size() < (qint64)sizeof(OfonoCdrFileHeader)) {
+        m_file.close();
+        return false;
+    } else {
+        capacity = (m_file.size() - (qint64)sizeof(OfonoCdrFileHeader)) / sizeof(OfonoCdrRecord);
+    }
+
+    if (!map(capacity)) {
+        m_file.close();
+        return false;
+    }
+
+    const OfonoCdrFileHeader *header = (const OfonoCdrFileHeader *)m_map;
+    if (header->magic != OFONO_CDR_MAGIC || header->version != OFONO_CDR_VERSION
+        || header->recordSize != sizeof(OfonoCdrRecord) || header->count > m_capacity) {
+        close();
+        return false;
+    }
+    m_synced = header->count;
+    if (m_syncInterval > 0)
+        m_syncTimer->start(m_syncInterval);
+    return true;
+}
+
+void OfonoCdrWriter::close()
+{
+    m_syncTimer->stop();
+    if (m_map) {
+        sync();
+        m_file.unmap(m_map);
+        m_map = 0;
+    }
+    m_capacity = 0;
+    m_synced = 0;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool OfonoCdrWriter::map(qint64 capacity)
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = 0;
+    }
+    qint64 size = sizeof(OfonoCdrFileHeader) + capacity * sizeof(OfonoCdrRecord);
+    if (m_file.size() < size && !m_file.resize(size))
+        return false;
+    m_map = m_file.map(0, size);
+    if (!m_map)
+        return false;
+    m_capacity = capacity;
+    return true;
+}
+
+qint64 OfonoCdrWriter::count() const
+{
+    if (!m_map)
+        return 0;
+    return ((const OfonoCdrFileHeader *)m_map)->count;
+}
+
+bool OfonoCdrWriter::append(const OfonoCdrRecord &record)
+{
+    if (!m_map)
+        return false;
+
+    qint64 n = count();
+    if (n == m_capacity) {
+        // the records in the old mapping go to disk before it is dropped
+        sync();
+        if (!map(m_capacity + GrowRecords)) {
+            close();
+            return false;
+        }
+    }
+
+    memcpy(m_map + sizeof(OfonoCdrFileHeader) + n * sizeof(OfonoCdrRecord),
+           &record, sizeof(record));
+    ((OfonoCdrFileHeader *)m_map)->count = n + 1;
+    emit recordWritten(record);
+    return true;
+}
+
+bool OfonoCdrWriter::sync()
+{
+    if (!m_map)
+        return false;
+
+    qint64 n = count();
+    if (n == m_synced)
+        return true;
+
+    // msync() wants a page aligned start; the header holds the count
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    qint64 begin = sizeof(OfonoCdrFileHeader) + m_synced * sizeof(OfonoCdrRecord);
+    qint64 end = sizeof(OfonoCdrFileHeader) + n * sizeof(OfonoCdrRecord);
+    begin -= begin % pageSize;
+    if (::msync(m_map + begin, end - begin, MS_SYNC) != 0
+        || (begin > 0 && ::msync(m_map, sizeof(OfonoCdrFileHeader), MS_SYNC) != 0))
+        return false;
+    m_synced = n;
+    return true;
+}
+
+void OfonoCdrWriter::setSyncInterval(int msecs)
+{
+    m_syncInterval = msecs;
+    if (msecs > 0 && m_map)
+        m_syncTimer->start(msecs);
+    else
+        m_syncTimer->stop();
+}
+
+OfonoCdrRecord::Technology OfonoCdrWriter::technologyFromString(const QString &technology)
+{
+    if (technology == "gsm")
+        return OfonoCdrRecord::Gsm;
+    if (technology == "gprs")
+        return OfonoCdrRecord::Gprs;
+    if (technology == "edge")
+        return OfonoCdrRecord::Edge;
+    if (technology == "umts")
+        return OfonoCdrRecord::Umts;
+    if (technology == "hsdpa")
+        return OfonoCdrRecord::Hsdpa;
+    if (technology == "hsupa")
+        return OfonoCdrRecord::Hsupa;
+    if (technology == "hspa")
+        return OfonoCdrRecord::Hspa;
+    if (technology == "lte")
+        return OfonoCdrRecord::Lte;
+    return OfonoCdrRecord::UnknownTechnology;
+}
+
+OfonoCdrRecord::DisconnectReason OfonoCdrWriter::disconnectReasonFromString(const QString &reason)
+{
+    if (reason == "local")
+        return OfonoCdrRecord::LocalReason;
+    if (reason == "remote")
+        return OfonoCdrRecord::RemoteReason;
+    if (reason == "network")
+        return OfonoCdrRecord::NetworkReason;
+    return OfonoCdrRecord::UnknownReason;
+}
+
+void OfonoCdrWriter::callAdded(const QString &path, const QVariantMap &values)
+{
+    PendingCall call;
+    call.addedAt = QDateTime::currentMSecsSinceEpoch();
+
+    QString state = values["State"].value<QString>();
+    if (state == "incoming" || state == "waiting")
+        call.direction = OfonoCdrRecord::Incoming;
+    else if (state == "dialing" || state == "alerting")
+        call.direction = OfonoCdrRecord::Outgoing;
+    else
+        call.direction = OfonoCdrRecord::UnknownDirection;
+    call.number = values["LineIdentification"].value<QString>();
+
+    if (m_registration && m_registration->isValid()) {
+        call.cellId = m_registration->cellId();
+        call.locationAreaCode = m_registration->locationAreaCode();
+        call.technology = technologyFromString(m_registration->technology());
+    } else {
+        call.cellId = 0;
+        call.locationAreaCode = 0;
+        call.technology = OfonoCdrRecord::UnknownTechnology;
+    }
+    m_pending.insert(path, call);
+}
+
+void OfonoCdrWriter::callRemoved(const QString &path)
+{
+    if (!m_pending.contains(path))
+        return;
+    PendingCall pending = m_pending.take(path);
+
+    OfonoCdrRecord record;
+    memset(&record, 0, sizeof(record));
+    record.addedAt = pending.addedAt;
+    record.removedAt = QDateTime::currentMSecsSinceEpoch();
+    record.startTime = -1;
+    record.answerTime = -1;
+    record.postDialDelay = -1;
+    record.direction = pending.direction;
+    record.technology = pending.technology;
+    record.cellId = pending.cellId;
+    record.locationAreaCode = pending.locationAreaCode;
+
+    QString number = pending.number;
+    // the manager deletes its call object only after callRemoved()
+    OfonoVoiceCall *call = m_manager ? m_manager->call(path) : 0;
+    if (call) {
+        const OfonoCallTimeline &timeline = call->timeline();
+        record.answerTime = timeline.answerTime();
+        record.postDialDelay = timeline.postDialDelay();
+        record.holdTime = timeline.holdTime();
+        record.disconnectReason = disconnectReasonFromString(timeline.disconnectReason());
+        if (record.answerTime >= 0) {
+            record.flags |= OfonoCdrRecord::Answered;
+            QDateTime start = QDateTime::fromString(call->startTime(), Qt::ISODate);
+            record.startTime = start.isValid() ? start.toMSecsSinceEpoch()
+                                               : record.addedAt + record.answerTime;
+        }
+        if (call->emergency())
+            record.flags |= OfonoCdrRecord::Emergency;
+        if (call->multiparty())
+            record.flags |= OfonoCdrRecord::Multiparty;
+        if (!call->lineIdentification().isEmpty())
+            number = call->lineIdentification();
+    }
+    QByteArray latin1 = number.toLatin1().left(sizeof(record.number));
+    memcpy(record.number, latin1.constData(), latin1.size());
+
+    append(record);
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCDRWRITER_H
+#define OFONOCDRWRITER_H
+
+#include <QtCore/QObject>
+#include <QFile>
+#include <QHash>
+#include <QPointer>
+#include <QVariant>
+
+#include "ofonocdrrecord.h"
+#include "libofono-qt_global.h"
+
+class QTimer;
+class OfonoVoiceCallManager;
+class OfonoNetworkRegistration;
+
+//! Writes a call detail record for every call to a file
+/*!
+ * A record is written when a call is removed from the voice call manager.
+ * It combines the registration of the modem when the call appeared, taken
+ * from the optional OfonoNetworkRegistration, with the call properties and
+ * the call timeline, see OfonoVoiceCall::timeline().
+ *
+ * The file holds a small header followed by OfonoCdrRecord entries, and is
+ * extended in steps of GrowRecords records. It is memory-mapped, so
+ * appending a record is a copy into the mapping; the mapping is synced to
+ * disk every syncInterval() milliseconds and when the file is closed.
+ * Records written before the file was opened again are kept.
+ *
+ * The file can be read with OfonoCdrReader, also while it is being written.
+ */
+class OFONO_QT_EXPORT OfonoCdrWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum { GrowRecords = 1024 };
+
+    OfonoCdrWriter(OfonoVoiceCallManager *manager, OfonoNetworkRegistration *registration=0, QObject *parent=0);
+    ~OfonoCdrWriter();
+
+    //! Opens a file for appending, creating it if needed
+    /*!
+     * Returns false if the file cannot be opened or is not a record file.
+     */
+    bool open(const QString &fileName);
+    //! Syncs and closes the file
+    void close();
+    bool isOpen() const {return m_map != 0;}
+    QString fileName() const {return m_file.fileName();}
+
+    //! Returns the number of records in the file
+    qint64 count() const;
+
+    //! Appends a record; returns false if the file is not open or cannot grow
+    bool append(const OfonoCdrRecord &record);
+
+    int syncInterval() const {return m_syncInterval;}
+    //! Sets how often appended records are synced; a non-positive interval only syncs on close
+    void setSyncInterval(int msecs);
+
+    static OfonoCdrRecord::Technology technologyFromString(const QString &technology);
+    static OfonoCdrRecord::DisconnectReason disconnectReasonFromString(const QString &reason);
+
+public Q_SLOTS:
+    //! Writes the records appended since the last sync to disk
+    bool sync();
+
+Q_SIGNALS:
+    void recordWritten(const OfonoCdrRecord &record);
+
+private Q_SLOTS:
+    void callAdded(const QString &path, const QVariantMap &values);
+    void callRemoved(const QString &path);
+
+private:
+    struct PendingCall {
+        qint64 addedAt;
+        quint8 direction;
+        quint8 technology;
+        quint32 cellId;
+        quint16 locationAreaCode;
+        QString number;
+    };
+
+    bool map(qint64 capacity);
+
+    QPointer<OfonoVoiceCallManager> m_manager;
+    QPointer<OfonoNetworkRegistration> m_registration;
+    QHash<QString, PendingCall> m_pending;
+    QFile m_file;
+    uchar *m_map;
+    qint64 m_capacity;
+    qint64 m_synced;
+    int m_syncInterval;
+    QTimer *m_syncTimer;
+};
+
+#endif // OFONOCDRWRITER_H
@@ -29,14 +29,25 @@
 
 OfonoCellBroadcast::OfonoCellBroadcast(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.CellBroadcast", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoCellBroadcast::OfonoCellBroadcast(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.CellBroadcast", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoCellBroadcast::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
 
-    QDBusConnection::systemBus().connect("org.ofono",path(),m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(),path(),m_if->ifname(),
                                          "IncomingBroadcast", this,
                                          SLOT(inBroadcast(const QString &, quint16)));
-    QDBusConnection::systemBus().connect("org.ofono",path(),m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(),path(),m_if->ifname(),
                                          "EmergencyBroadcast", this,
                                          SLOT(emBroadcast(const QString &,const QVariantMap &)));
 }
@@ -51,6 +51,8 @@ class OFONO_QT_EXPORT OfonoCellBroadcast : public OfonoModemInterface
 
 public:
     explicit OfonoCellBroadcast(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent = 0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoCellBroadcast(OfonoModem *modem, QObject *parent=0);
     ~OfonoCellBroadcast();
 
     QString path() const;
@@ -75,6 +77,9 @@ private Q_SLOTS:
     void inBroadcast(const QString &message, quint16 channel);
     void emBroadcast(const QString &message, const QVariantMap &properties);
 
+
+private:
+    void init();
 };
 
 #endif // OFONOCELLBROADCAST_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtDBus/QtDBus>
+#include <QtCore/QObject>
+
+#include "ofonoconference.h"
+#include "ofonovoicecallmanager.h"
+#include "ofonovoicecall.h"
+
+#define CONFERENCE_TIMEOUT 30000
+
+OfonoConference::OfonoConference(OfonoVoiceCallManager *manager, QObject *parent)
+    : QObject(parent), m_manager(manager), m_joinRequested(-1), m_joinReplied(false),
+      m_joinLatency(-1), m_leaveLatency(-1)
+{
+    m_clock.start();
+    if (!m_manager)
+        return;
+
+    connect(m_manager, SIGNAL(callAdded(const QString&, const QVariantMap&)),
+            this, SLOT(callAdded(const QString&, const QVariantMap&)));
+    connect(m_manager, SIGNAL(callRemoved(const QString&)),
+            this, SLOT(callRemoved(const QString&)));
+
+    foreach (OfonoVoiceCall *call, m_manager->callObjects())
+        watchCall(call->path());
+}
+
+OfonoConference::~OfonoConference()
+{
+}
+
+void OfonoConference::create()
+{
+    if (!m_manager)
+        return;
+    m_joinRequested = now();
+    m_joinPending.clear();
+    m_joinReplied = false;
+    // the scheduler may outlive the conference
+    QPointer<OfonoConference> self(this);
+    m_manager->scheduleMultiparty("CreateMultiparty", QVariantList(), CONFERENCE_TIMEOUT,
+                                  [self](const QDBusPendingCall &pending) {
+        if (self)
+            self->createFinished(pending);
+    });
+}
+
+void OfonoConference::split(const QString &call)
+{
+    if (!m_manager)
+        return;
+    m_leaveRequested.insert(call, now());
+    QVariantList arg;
+    arg.append(QVariant::fromValue(QDBusObjectPath(call)));
+    QPointer<OfonoConference> self(this);
+    m_manager->scheduleMultiparty("PrivateChat", arg, CONFERENCE_TIMEOUT,
+                                  [self, call](const QDBusPendingCall &pending) {
+        if (!self)
+            return;
+        QStringList calls;
+        bool status = self->checkReply(pending, &calls);
+        if (!status)
+            self->m_leaveRequested.remove(call);
+        emit self->splitComplete(status, calls);
+    });
+}
+
+void OfonoConference::hangup()
+{
+    if (!m_manager)
+        return;
+    qint64 requested = now();
+    foreach (QString call, m_members.toList())
+        m_leaveRequested.insert(call, requested);
+    QPointer<OfonoConference> self(this);
+    m_manager->scheduleMultiparty("HangupMultiparty", QVariantList(), CONFERENCE_TIMEOUT,
+                                  [self](const QDBusPendingCall &pending) {
+        if (!self)
+            return;
+        bool status = self->checkReply(pending, 0);
+        if (!status)
+            self->m_leaveRequested.clear();
+        emit self->hangupComplete(status);
+    });
+}
+
+void OfonoConference::createFinished(const QDBusPendingCall &pending)
+{
+    QStringList calls;
+    bool status = checkReply(pending, &calls);
+    if (status) {
+        // the Multiparty changes may arrive before or after the reply
+        m_joinReplied = true;
+        foreach (QString call, calls) {
+            if (!m_members.contains(call))
+                m_joinPending << call;
+        }
+    }
+    if (!status || m_joinPending.isEmpty())
+        m_joinRequested = -1;
+    emit createComplete(status, calls);
+}
+
+bool OfonoConference::checkReply(const QDBusPendingCall &pending, QStringList *calls)
+{
+    if (pending.isError()) {
+        m_errorName = pending.error().name();
+        m_errorMessage = pending.error().message();
+        return false;
+    }
+    if (calls) {
+        QDBusPendingReply<QList<QDBusObjectPath> > reply = pending;
+        foreach (QDBusObjectPath path, reply.value())
+            *calls << path.path();
+    }
+    return true;
+}
+
+void OfonoConference::watchCall(const QString &path)
+{
+    OfonoVoiceCall *call = m_manager ? m_manager->call(path) : 0;
+    if (!call)
+        return;
+    connect(call, SIGNAL(multipartyChanged(const bool)),
+            this, SLOT(multipartyChanged(bool)));
+    if (call->multiparty())
+        join(path);
+}
+
+void OfonoConference::callAdded(const QString &call, const QVariantMap &/*values*/)
+{
+    // the manager creates its call object before issuing callAdded()
+    watchCall(call);
+}
+
+void OfonoConference::callRemoved(const QString &call)
+{
+    leave(call);
+}
+
+void OfonoConference::multipartyChanged(bool multiparty)
+{
+    OfonoVoiceCall *call = qobject_cast<OfonoVoiceCall *>(sender());
+    if (!call)
+        return;
+    if (multiparty)
+        join(call->path());
+    else
+        leave(call->path());
+}
+
+void OfonoConference::join(const QString &call)
+{
+    if (!m_members.insert(call))
+        return;
+    if (m_joinRequested >= 0) {
+        m_joinLatency = now() - m_joinRequested;
+        m_joinPending.removeAll(call);
+        if (m_joinReplied && m_joinPending.isEmpty())
+            m_joinRequested = -1;
+    }
+    emit memberJoined(call);
+    emit membersChanged(members());
+}
+
+void OfonoConference::leave(const QString &call)
+{
+    if (!m_members.remove(call))
+        return;
+    if (m_leaveRequested.contains(call))
+        m_leaveLatency = now() - m_leaveRequested.take(call);
+    emit memberLeft(call);
+    emit membersChanged(members());
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCONFERENCE_H
+#define OFONOCONFERENCE_H
+
+#include <QtCore/QObject>
+#include <QHash>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVariant>
+
+#include "ofonopathset.h"
+#include "libofono-qt_global.h"
+
+class QDBusPendingCall;
+class OfonoVoiceCallManager;
+
+//! Tracks the multiparty call of a voice call manager
+/*!
+ * Membership follows the Multiparty property of the call objects kept by
+ * the manager, see OfonoVoiceCallManager::call(), and calls leave the
+ * conference when they are removed. create(), split() and hangup() do not
+ * block; they are sent through the multiparty lane of the manager's
+ * scheduler and report with createComplete(), splitComplete() and
+ * hangupComplete().
+ *
+ * joinLatency() and leaveLatency() measure the time from a request until
+ * a call joined or left because of it, in microseconds, or -1 if no such
+ * change has been seen yet.
+ */
+class OFONO_QT_EXPORT OfonoConference : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QStringList members READ members NOTIFY membersChanged)
+    Q_PROPERTY(QString errorName READ errorName)
+    Q_PROPERTY(QString errorMessage READ errorMessage)
+
+public:
+    explicit OfonoConference(OfonoVoiceCallManager *manager, QObject *parent=0);
+    ~OfonoConference();
+
+    OfonoVoiceCallManager *manager() const {return m_manager;}
+
+    //! Returns the member calls, in the order they joined
+    QStringList members() const {return m_members.toList();}
+    bool contains(const QString &call) const {return m_members.contains(call);}
+    int count() const {return m_members.count();}
+    bool isActive() const {return !m_members.isEmpty();}
+
+    qint64 joinLatency() const {return m_joinLatency;}
+    qint64 leaveLatency() const {return m_leaveLatency;}
+
+    //! Get the D-Bus error name of the last failed operation
+    QString errorName() const {return m_errorName;}
+    //! Get the D-Bus error message of the last failed operation
+    QString errorMessage() const {return m_errorMessage;}
+
+public Q_SLOTS:
+    //! Joins the active and held calls into the conference
+    void create();
+    //! Takes a call out of the conference into a private chat; the other members are held
+    void split(const QString &call);
+    //! Hangs up all members
+    void hangup();
+
+Q_SIGNALS:
+    void memberJoined(const QString &call);
+    void memberLeft(const QString &call);
+    void membersChanged(const QStringList &members);
+    void createComplete(const bool status, const QStringList &calls);
+    void splitComplete(const bool status, const QStringList &calls);
+    void hangupComplete(const bool status);
+
+private Q_SLOTS:
+    void callAdded(const QString &call, const QVariantMap &values);
+    void callRemoved(const QString &call);
+    void multipartyChanged(bool multiparty);
+
+private:
+    void watchCall(const QString &call);
+    void join(const QString &call);
+    void leave(const QString &call);
+    void createFinished(const QDBusPendingCall &pending);
+    bool checkReply(const QDBusPendingCall &pending, QStringList *calls);
+    qint64 now() const {return m_clock.nsecsElapsed() / 1000;}
+
+    QPointer<OfonoVoiceCallManager> m_manager;
+    OfonoPathSet m_members;
+    QElapsedTimer m_clock;
+    qint64 m_joinRequested;
+    QStringList m_joinPending;
+    bool m_joinReplied;
+    QHash<QString, qint64> m_leaveRequested;
+    qint64 m_joinLatency;
+    qint64 m_leaveLatency;
+    QString m_errorName;
+    QString m_errorMessage;
+};
+
+#endif // OFONOCONFERENCE_H
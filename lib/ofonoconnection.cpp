@@ -0,0 +1,78 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QMutex>
+
+#include "ofonoconnection.h"
+
+static QMutex defaultConnectionMutex;
+static OfonoConnection *defaultConnectionOverride = 0;
+static thread_local OfonoConnectionScope *currentScope = 0;
+
+OfonoConnection::OfonoConnection()
+    : m_bus(QDBusConnection::systemBus()), m_service("org.ofono")
+{
+}
+
+OfonoConnection::OfonoConnection(const QDBusConnection &bus, const QString &service)
+    : m_bus(bus), m_service(service)
+{
+}
+
+bool OfonoConnection::operator==(const OfonoConnection &other) const
+{
+    return m_bus.name() == other.m_bus.name() && m_service == other.m_service;
+}
+
+OfonoConnection OfonoConnection::current()
+{
+    if (currentScope)
+        return currentScope->m_connection;
+    return defaultConnection();
+}
+
+OfonoConnection OfonoConnection::defaultConnection()
+{
+    QMutexLocker locker(&defaultConnectionMutex);
+    if (defaultConnectionOverride)
+        return *defaultConnectionOverride;
+    return OfonoConnection();
+}
+
+void OfonoConnection::setDefaultConnection(const OfonoConnection &connection)
+{
+    QMutexLocker locker(&defaultConnectionMutex);
+    delete defaultConnectionOverride;
+    defaultConnectionOverride = new OfonoConnection(connection);
+}
+
+OfonoConnectionScope::OfonoConnectionScope(const OfonoConnection &connection)
+    : m_connection(connection), m_previous(currentScope)
+{
+    currentScope = this;
+}
+
+OfonoConnectionScope::~OfonoConnectionScope()
+{
+    currentScope = m_previous;
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCONNECTION_H
+#define OFONOCONNECTION_H
+
+#include <QString>
+#include <QDBusConnection>
+#include "libofono-qt_global.h"
+
+//! The D-Bus connection and service name used to reach oFono
+/*!
+ * By default, the library talks to the "org.ofono" service on the system bus.
+ * Every library object picks its connection when it is constructed, from
+ * the innermost OfonoConnectionScope active in the constructing thread, or
+ * else from the process-wide default connection. Objects created internally
+ * by another object, such as the modem of a modem interface, use the same
+ * connection as their creator.
+ *
+ * This allows using a private bus, a peer-to-peer connection or a session
+ * bus served by a mock daemon, and talking to several oFono instances from
+ * one process.
+ */
+class OFONO_QT_EXPORT OfonoConnection
+{
+public:
+    //! Constructs a connection to "org.ofono" on the system bus
+    OfonoConnection();
+    OfonoConnection(const QDBusConnection &bus, const QString &service = QString("org.ofono"));
+
+    QDBusConnection bus() const {return m_bus;}
+    QString service() const {return m_service;}
+
+    bool operator==(const OfonoConnection &other) const;
+    bool operator!=(const OfonoConnection &other) const {return !(*this == other);}
+
+    //! Returns the connection used by objects constructed now in the current thread
+    static OfonoConnection current();
+
+    //! Returns the process-wide default connection
+    static OfonoConnection defaultConnection();
+
+    //! Sets the process-wide default connection for objects constructed from now on
+    static void setDefaultConnection(const OfonoConnection &connection);
+
+private:
+    QDBusConnection m_bus;
+    QString m_service;
+};
+
+//! Makes the library objects constructed in its lifetime use a given connection
+/*!
+ * The scope applies to the thread in which it is created. Scopes nest, for example
+ *
+ * \code
+ * {
+ *     OfonoConnectionScope scope(OfonoConnection(QDBusConnection::sessionBus()));
+ *     OfonoModem *modem = new OfonoModem(OfonoModem::AutomaticSelect, QString());
+ * }
+ * \endcode
+ */
+class OFONO_QT_EXPORT OfonoConnectionScope
+{
+public:
+    explicit OfonoConnectionScope(const OfonoConnection &connection);
+    ~OfonoConnectionScope();
+
+private:
+    Q_DISABLE_COPY(OfonoConnectionScope)
+
+    OfonoConnection m_connection;
+    OfonoConnectionScope *m_previous;
+
+    friend class OfonoConnection;
+};
+
+#endif
@@ -26,6 +26,9 @@
 
 #include "ofonoconnman.h"
 #include "ofonointerface.h"
+#include "ofonoeventbus.h"
+#include "ofonoservicetracker.h"
+#include "ofonopropertycache.h"
 
 #define DEACTIVATE_TIMEOUT 30000
 #define ADD_TIMEOUT 30000
@@ -49,11 +52,23 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, OfonoConnmanStruc
 
 OfonoConnMan::OfonoConnMan(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.ConnectionManager", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoConnMan::OfonoConnMan(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.ConnectionManager", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoConnMan::init()
 {
     qDBusRegisterMetaType<OfonoConnmanStruct>();
     qDBusRegisterMetaType<OfonoConnmanList>();
 
-    m_contextlist = getContextList();
+    m_refreshWatcher = 0;
+    m_contextlist = OfonoPathSet(getContextList());
 
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -64,15 +79,42 @@ OfonoConnMan::OfonoConnMan(OfonoModem::SelectionSetting modemSetting, const QStr
     connect(modem(), SIGNAL(pathChanged(QString)), this, SLOT(pathChanged(const QString&)));
 
     connectDbusSignals(path());
+
+    OfonoServiceTracker *tracker = OfonoServiceTracker::forConnection(m_if->connection());
+    connect(tracker, SIGNAL(serviceLost()), this, SLOT(onServiceLost()));
+    connect(tracker, SIGNAL(serviceReturned()), this, SLOT(onServiceReturned()));
 }
 
 OfonoConnMan::~OfonoConnMan()
 {
 }
 
-void OfonoConnMan::validityChanged(bool /*validity*/)
+void OfonoConnMan::validityChanged(bool validity)
 {
-    m_contextlist = getContextList();
+    // the contexts of another modem are fetched without blocking; until the
+    // reply arrives the list is left as it is
+    delete m_refreshWatcher;
+    m_refreshWatcher = 0;
+    if (!validity) {
+        m_contextlist = OfonoPathSet();
+        return;
+    }
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                          path(), m_if->ifname(),
+                                                          "GetContexts");
+    m_refreshWatcher = new QDBusPendingCallWatcher(m_if->connection().bus().asyncCall(request), this);
+    connect(m_refreshWatcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(refreshContextsFinished(QDBusPendingCallWatcher*)));
+}
+
+void OfonoConnMan::refreshContextsFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<OfonoConnmanList> reply = *watcher;
+    watcher->deleteLater();
+    m_refreshWatcher = 0;
+
+    m_contextlist = OfonoPathSet(contextPaths(reply.isError() ? OfonoConnmanList() : reply.value()));
 }
 
 void OfonoConnMan::pathChanged(const QString& path)
@@ -88,34 +130,42 @@ QStringList OfonoConnMan::getContextList()
 
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "GetContexts");
 
-    reply = QDBusConnection::systemBus().call(request);
+    reply = m_if->connection().bus().call(request);
 
     contexts = reply;
+    return contextPaths(contexts);
+}
+
+QStringList OfonoConnMan::contextPaths(const OfonoConnmanList &contexts)
+{
+    QStringList contextList;
+    OfonoPropertyCache *cache = OfonoPropertyCache::forConnection(m_if->connection());
     foreach(OfonoConnmanStruct context, contexts) {
         contextList << context.path.path();
+        cache->seed(context.path.path(), "org.ofono.ConnectionContext", context.properties);
     }
     return contextList;
 }
 
 void OfonoConnMan::connectDbusSignals(const QString& path)
 {
-    QDBusConnection::systemBus().disconnect("org.ofono",QString(),m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(),QString(),m_if->ifname(),
                                          "ContextAdded", this,
                                          SLOT(contextAddedChanged(const QDBusObjectPath&, const QVariantMap&)));
 
-    QDBusConnection::systemBus().disconnect("org.ofono",QString(),m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(),QString(),m_if->ifname(),
                                          "ContextRemoved", this,
                                          SLOT(contextRemovedChanged(const QDBusObjectPath&)));
 
-    QDBusConnection::systemBus().connect("org.ofono",path,m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(),path,m_if->ifname(),
                                          "ContextAdded", this,
                                          SLOT(contextAddedChanged(const QDBusObjectPath&, const QVariantMap&)));
 
-    QDBusConnection::systemBus().connect("org.ofono",path,m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(),path,m_if->ifname(),
                                          "ContextRemoved", this,
                                          SLOT(contextRemovedChanged(const QDBusObjectPath&)));
 
@@ -125,11 +175,11 @@ void OfonoConnMan::deactivateAll()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
                                              "DeactivateAll");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
                                         SLOT(deactivateAllResp()),
                                         SLOT(deactivateAllErr(const QDBusError&)),
                                         DEACTIVATE_TIMEOUT);
@@ -151,7 +201,7 @@ QDBusObjectPath OfonoConnMan::addContext(const QString& type, bool &success)
     QDBusMessage request;
     QDBusReply<QDBusObjectPath> reply;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
                                              "AddContext");
 
@@ -159,7 +209,7 @@ QDBusObjectPath OfonoConnMan::addContext(const QString& type, bool &success)
     arg.append(QVariant(type));
     request.setArguments(arg);
 
-    reply = QDBusConnection::systemBus().call(request);
+    reply = m_if->connection().bus().call(request);
     success = reply.isValid();
     if (!success) {
         m_if->setError(reply.error().name(), reply.error().message());
@@ -182,7 +232,7 @@ void OfonoConnMan::removeContext(const QString& contextpath)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
                                              "RemoveContext");
 
@@ -190,7 +240,7 @@ void OfonoConnMan::removeContext(const QString& contextpath)
     QDBusObjectPath context (contextpath);
     argumentList << QVariant::fromValue(context);
     request.setArguments(argumentList);
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
                                         SLOT(removeContextResp()),
                                         SLOT(removeContextErr(const QDBusError&)),
                                         REMOVE_TIMEOUT);
@@ -249,18 +299,22 @@ void OfonoConnMan::propertyChanged(const QString& property, const QVariant& valu
 
 QStringList OfonoConnMan::getContexts()
 {
-    return m_contextlist;
+    return m_contextlist.toList();
 }
 
-void OfonoConnMan::contextAddedChanged(const QDBusObjectPath &path, const QVariantMap& /*values*/)
+void OfonoConnMan::contextAddedChanged(const QDBusObjectPath &path, const QVariantMap& values)
 {
-    m_contextlist << path.path();
+    m_contextlist.insert(path.path());
+    OfonoPropertyCache::forConnection(m_if->connection())->seed(path.path(), "org.ofono.ConnectionContext", values);
+    OfonoEventBus::instance()->publish(OfonoEvent::ContextAdded, path.path(), "org.ofono.ConnectionContext", values);
     emit contextAdded(path.path());
 }
 
 void OfonoConnMan::contextRemovedChanged(const QDBusObjectPath &path)
 {
-    m_contextlist.removeAll(path.path());
+    m_contextlist.remove(path.path());
+    OfonoPropertyCache::forConnection(m_if->connection())->forget(path.path());
+    OfonoEventBus::instance()->publish(OfonoEvent::ContextRemoved, path.path(), "org.ofono.ConnectionContext");
     emit contextRemoved(path.path());
 }
 
@@ -282,3 +336,36 @@ void OfonoConnMan::setPropertyFailed(const QString &property)
         emit setRoamingAllowedFailed();
     }
 }
+
+void OfonoConnMan::onServiceLost()
+{
+    foreach (QString context, m_contextlist.toList())
+        contextRemovedChanged(QDBusObjectPath(context));
+}
+
+void OfonoConnMan::onServiceReturned()
+{
+    if (path() == "/")
+        return;
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                          path(), m_if->ifname(),
+                                                          "GetContexts");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_if->connection().bus().asyncCall(request), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(resyncContextsFinished(QDBusPendingCallWatcher*)));
+    OfonoServiceTracker::forConnection(m_if->connection())->addFetch(watcher);
+}
+
+void OfonoConnMan::resyncContextsFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<OfonoConnmanList> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError())
+        return;
+    foreach (OfonoConnmanStruct context, reply.value()) {
+        if (!m_contextlist.contains(context.path.path()))
+            contextAddedChanged(context.path, context.properties);
+    }
+}
@@ -29,8 +29,11 @@
 #include <QDBusError>
 #include <QDBusObjectPath>
 #include "ofonomodeminterface.h"
+#include "ofonopathset.h"
 #include "libofono-qt_global.h"
 
+class QDBusPendingCallWatcher;
+
 struct OfonoConnmanStruct {
     QDBusObjectPath path;
     QVariantMap properties;
@@ -56,10 +59,15 @@ class OFONO_QT_EXPORT OfonoConnMan : public OfonoModemInterface
 
 public:
     OfonoConnMan(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoConnMan(OfonoModem *modem, QObject *parent=0);
     ~OfonoConnMan();
 
     Q_INVOKABLE QStringList getContexts();
 
+    //! Returns the contexts as a set, for constant-time lookups
+    const OfonoPathSet &contextPaths() const {return m_contextlist;}
+
     /* Properties */
     bool attached() const;
     QString bearer() const;
@@ -96,6 +104,10 @@ private Q_SLOTS:
     void propertyChanged(const QString& property, const QVariant& value);
     void contextAddedChanged(const QDBusObjectPath &path, const QVariantMap &properties);
     void contextRemovedChanged(const QDBusObjectPath &path);
+    void onServiceLost();
+    void onServiceReturned();
+    void resyncContextsFinished(QDBusPendingCallWatcher *watcher);
+    void refreshContextsFinished(QDBusPendingCallWatcher *watcher);
     void deactivateAllResp();
     void deactivateAllErr(const QDBusError& error);
     void addContextResp(const QDBusObjectPath &path);
@@ -105,9 +117,12 @@ private Q_SLOTS:
     void setPropertyFailed(const QString& property);
 private:
     QStringList getContextList();
+    QStringList contextPaths(const OfonoConnmanList &contexts);
     void connectDbusSignals(const QString& path);
 private:
-    QStringList m_contextlist;
+    void init();
+    OfonoPathSet m_contextlist;
+    QDBusPendingCallWatcher *m_refreshWatcher;
 };
 
 #endif  /* !OFONOCONNMAN_H */
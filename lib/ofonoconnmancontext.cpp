@@ -31,29 +31,44 @@
 
 
 OfonoConnmanContext::OfonoConnmanContext(const QString& contextId, QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_if(0)
 {
-    m_if = new OfonoInterface(contextId, "org.ofono.ConnectionContext", OfonoGetAllOnStartup, this);
+    // the last copy may go away from a slot connected to the shared state
+    attach(QSharedPointer<OfonoInterface>(new OfonoInterface(contextId, "org.ofono.ConnectionContext", OfonoGetAllOnStartup),
+                                          &QObject::deleteLater));
+}
 
-    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
-            this, SLOT(propertyChanged(const QString&, const QVariant&)));
-    connect(m_if, SIGNAL(setPropertyFailed(const QString&)),
-            this, SLOT(setPropertyFailed(const QString&)));
+OfonoConnmanContext::OfonoConnmanContext(const OfonoConnmanContext& context)
+    : QObject(context.parent()), m_if(0)
+{
+    attach(context.m_shared);
+}
 
+OfonoConnmanContext::OfonoConnmanContext(OfonoConnmanContext &&context)
+    : QObject(context.parent()), m_if(0)
+{
+    attach(context.detach());
 }
 
-OfonoConnmanContext::OfonoConnmanContext(const OfonoConnmanContext& context)
-    : QObject(context.parent())
+OfonoConnmanContext &OfonoConnmanContext::operator=(const OfonoConnmanContext &context)
 {
-    m_if = new OfonoInterface(context.path(), "org.ofono.ConnectionContext", OfonoGetAllOnStartup, this);
+    if (m_shared != context.m_shared) {
+        detach();
+        attach(context.m_shared);
+    }
+    return *this;
+}
 
-    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
-            this, SLOT(propertyChanged(const QString&, const QVariant&)));
-    connect(m_if, SIGNAL(setPropertyFailed(const QString&)),
-            this, SLOT(setPropertyFailed(const QString&)));
+OfonoConnmanContext &OfonoConnmanContext::operator=(OfonoConnmanContext &&context)
+{
+    if (this != &context) {
+        detach();
+        attach(context.detach());
+    }
+    return *this;
 }
 
-bool OfonoConnmanContext::operator==(const OfonoConnmanContext &context)
+bool OfonoConnmanContext::operator==(const OfonoConnmanContext &context) const
 {
     return path() == context.path();
 }
@@ -62,6 +77,29 @@ OfonoConnmanContext::~OfonoConnmanContext()
 {
 }
 
+void OfonoConnmanContext::attach(const QSharedPointer<OfonoInterface> &shared)
+{
+    m_shared = shared;
+    if (!m_shared)
+        return;
+    m_if = m_shared.data();
+
+    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
+            this, SLOT(propertyChanged(const QString&, const QVariant&)));
+    connect(m_if, SIGNAL(setPropertyFailed(const QString&)),
+            this, SLOT(setPropertyFailed(const QString&)));
+}
+
+QSharedPointer<OfonoInterface> OfonoConnmanContext::detach()
+{
+    QSharedPointer<OfonoInterface> shared;
+    if (m_shared)
+        disconnect(m_if, 0, this, 0);
+    shared.swap(m_shared);
+    m_if = 0;
+    return shared;
+}
+
 bool OfonoConnmanContext::active() const
 {
     return m_if->properties()["Active"].value<bool>();
@@ -235,3 +273,23 @@ void OfonoConnmanContext::setPropertyFailed(const QString &property)
         emit setMessageCenterFailed();
     }
 }
+
+int OfonoConnmanContext::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    return m_if->addPropertyCallback(name, callback);
+}
+
+void OfonoConnmanContext::removePropertyCallback(int handle)
+{
+    m_if->removePropertyCallback(handle);
+}
+
+OfonoPropertySnapshot OfonoConnmanContext::snapshot() const
+{
+    return m_if->snapshot();
+}
+
+bool OfonoConnmanContext::isStale() const
+{
+    return m_if->isStale();
+}
@@ -27,7 +27,10 @@
 #include <QVariant>
 #include <QStringList>
 #include <QDBusError>
+#include <QSharedPointer>
 
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
 #include "libofono-qt_global.h"
 
 class OfonoInterface;
@@ -36,6 +39,10 @@ class OfonoInterface;
 /*!
  * The API is documented in
  * http://git.kernel.org/?p=network/ofono/ofono.git;a=blob;f=doc/connman-api.txt
+ *
+ * Copies are cheap: they share the property cache and the D-Bus
+ * subscriptions of the original, so copying does not talk to oFono. A
+ * moved-from object may only be assigned to or destroyed.
  */
 class OFONO_QT_EXPORT OfonoConnmanContext : public QObject
 {
@@ -60,10 +67,15 @@ class OFONO_QT_EXPORT OfonoConnmanContext : public QObject
 public:
     OfonoConnmanContext(const QString &contextPath, QObject *parent=0);
     OfonoConnmanContext(const OfonoConnmanContext &op);
+    OfonoConnmanContext(OfonoConnmanContext &&op);
     ~OfonoConnmanContext();
 
-    OfonoConnmanContext operator=(const OfonoConnmanContext &op);
-    bool operator==(const OfonoConnmanContext &op);
+    OfonoConnmanContext &operator=(const OfonoConnmanContext &op);
+    OfonoConnmanContext &operator=(OfonoConnmanContext &&op);
+    bool operator==(const OfonoConnmanContext &op) const;
+
+    //! Returns true if both objects share the same backing state
+    bool isSharedWith(const OfonoConnmanContext &op) const {return m_shared == op.m_shared;}
 
     //! Returns the D-Bus object path of the voice call object
     QString path() const;
@@ -95,6 +107,27 @@ public:
     QVariantMap settings() const;
     QVariantMap IPv6Settings() const;
 
+    //! Registers a callback for changes of a context property
+    /*!
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
+
+    //! Returns an immutable snapshot of all context properties
+    /*!
+     * See OfonoInterface::snapshot().
+     */
+    OfonoPropertySnapshot snapshot() const;
+
+    //! Returns true if the context properties were loaded from a saved cache and are not confirmed yet
+    /*!
+     * See OfonoPropertyCache::load().
+     */
+    bool isStale() const;
+
 public Q_SLOTS:
     void setActive(const bool);
     void setAccessPointName(const QString&);
@@ -136,6 +169,11 @@ private Q_SLOTS:
     void setPropertyFailed(const QString& property);
 
 private:
+    void attach(const QSharedPointer<OfonoInterface> &shared);
+    QSharedPointer<OfonoInterface> detach();
+
+private:
+    QSharedPointer<OfonoInterface> m_shared;
     OfonoInterface *m_if;
 
 };
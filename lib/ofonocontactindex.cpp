@@ -0,0 +1,289 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QTimer>
+
+#include "ofonocontactindex.h"
+#include "ofonocallhistory.h"
+#include "ofonovoicecallmanager.h"
+#include "ofonovoicecall.h"
+#include "ofonophonebook.h"
+
+#define CONTACT_MATCH_DIGITS 7
+#define CONTACT_LOAD_CHUNK 32
+#define CONTACT_CACHE_SIZE 256
+
+static bool isIncoming(const QString &state)
+{
+    return state == "incoming" || state == "waiting";
+}
+
+static QString unescapeValue(QString value)
+{
+    value.replace("\\n", " ");
+    value.replace("\\N", " ");
+    value.replace("\\,", ",");
+    value.replace("\\;", ";");
+    value.replace("\\\\", "\\");
+    return value.trimmed();
+}
+
+OfonoContactIndex::OfonoContactIndex(OfonoVoiceCallManager *manager, QObject *parent)
+    : QObject(parent), m_manager(manager), m_cache(CONTACT_CACHE_SIZE), m_linePos(0)
+{
+    m_loadTimer = new QTimer(this);
+    m_loadTimer->setInterval(0);
+    connect(m_loadTimer, SIGNAL(timeout()), this, SLOT(loadNext()));
+
+    if (m_manager) {
+        connect(m_manager, SIGNAL(callAdded(const QString&, const QVariantMap&)),
+                this, SLOT(callAdded(const QString&, const QVariantMap&)));
+        connect(m_manager, SIGNAL(callRemoved(const QString&)),
+                this, SLOT(callRemoved(const QString&)));
+        foreach (OfonoVoiceCall *call, m_manager->callObjects()) {
+            QVariantMap values;
+            values["State"] = call->state();
+            values["LineIdentification"] = call->lineIdentification();
+            callAdded(call->path(), values);
+        }
+    }
+}
+
+OfonoContactIndex::~OfonoContactIndex()
+{
+}
+
+void OfonoContactIndex::setPhonebook(OfonoPhonebook *phonebook)
+{
+    if (m_phonebook)
+        disconnect(m_phonebook, 0, this, 0);
+    m_phonebook = phonebook;
+    if (!m_phonebook)
+        return;
+
+    connect(m_phonebook, SIGNAL(importComplete(bool, const QString&)),
+            this, SLOT(importComplete(bool, const QString&)));
+    connect(m_phonebook, SIGNAL(validityChanged(bool)),
+            this, SLOT(phonebookValidityChanged(bool)));
+    if (m_phonebook->isValid())
+        m_phonebook->import();
+}
+
+void OfonoContactIndex::insert(const QString &number, const QString &name)
+{
+    addNumber(m_numbers, m_suffixes, number, name);
+    m_cache.clear();
+}
+
+void OfonoContactIndex::clear()
+{
+    m_numbers.clear();
+    m_suffixes.clear();
+    m_cache.clear();
+}
+
+bool OfonoContactIndex::isLoading() const
+{
+    return m_loadTimer->isActive();
+}
+
+QString OfonoContactIndex::lookup(const QString &number) const
+{
+    QString key = OfonoCallHistory::normalizeNumber(number);
+    if (key.isEmpty())
+        return QString();
+    if (QString *cached = m_cache.object(key))
+        return *cached;
+
+    QString name = m_numbers.value(key);
+    if (name.isEmpty()) {
+        QString suffix = matchSuffix(key);
+        if (!suffix.isEmpty())
+            name = m_suffixes.value(suffix);
+    }
+    m_cache.insert(key, new QString(name));
+    return name;
+}
+
+void OfonoContactIndex::load(const QString &vcards)
+{
+    m_lines = vcards.split('\n');
+    m_linePos = 0;
+    m_loadNumbers.clear();
+    m_loadSuffixes.clear();
+    m_loadTimer->start();
+}
+
+void OfonoContactIndex::loadNext()
+{
+    QStringList card;
+    int cards = 0;
+    while (m_linePos < m_lines.count() && cards < CONTACT_LOAD_CHUNK) {
+        QString line = m_lines.at(m_linePos++);
+        if (line.endsWith('\r'))
+            line.chop(1);
+        // folded lines continue after a single space or tab
+        if (!card.isEmpty() && (line.startsWith(' ') || line.startsWith('\t'))) {
+            card.last().append(line.mid(1));
+            continue;
+        }
+        if (line.compare("END:VCARD", Qt::CaseInsensitive) == 0) {
+            parseCard(card);
+            card.clear();
+            ++cards;
+            continue;
+        }
+        card.append(line);
+    }
+    // a chunk always ends after a card, unless the text ends without one
+    if (m_linePos < m_lines.count())
+        return;
+
+    m_loadTimer->stop();
+    m_lines.clear();
+    m_numbers.swap(m_loadNumbers);
+    m_suffixes.swap(m_loadSuffixes);
+    m_loadNumbers.clear();
+    m_loadSuffixes.clear();
+    m_cache.clear();
+    emit loaded(count());
+
+    QHash<QString, QString> unresolved = m_unresolved;
+    QHash<QString, QString>::const_iterator i;
+    for (i = unresolved.constBegin(); i != unresolved.constEnd(); ++i)
+        resolve(i.key(), i.value());
+}
+
+void OfonoContactIndex::parseCard(const QStringList &lines)
+{
+    QString name;
+    QString structuredName;
+    QStringList numbers;
+    foreach (QString line, lines) {
+        int colon = line.indexOf(':');
+        if (colon < 0)
+            continue;
+        // drop the parameters and the group, as in "item1.TEL;TYPE=CELL"
+        QString property = line.left(colon).section(';', 0, 0).section('.', -1).toUpper();
+        QString value = line.mid(colon + 1);
+        if (property == "FN") {
+            name = unescapeValue(value);
+        } else if (property == "N") {
+            QStringList parts = value.split(';');
+            structuredName = unescapeValue(QString(parts.value(1) + ' ' + parts.value(0)));
+        } else if (property == "TEL") {
+            numbers << value;
+        }
+    }
+    if (name.isEmpty())
+        name = structuredName;
+    if (name.isEmpty())
+        return;
+    foreach (QString number, numbers)
+        addNumber(m_loadNumbers, m_loadSuffixes, number, name);
+}
+
+void OfonoContactIndex::addNumber(QHash<QString, QString> &numbers, QHash<QString, QString> &suffixes,
+                                  const QString &number, const QString &name)
+{
+    QString key = OfonoCallHistory::normalizeNumber(number);
+    if (key.isEmpty() || name.isEmpty())
+        return;
+    numbers.insert(key, name);
+
+    QString suffix = matchSuffix(key);
+    if (suffix.isEmpty())
+        return;
+    // a suffix shared by different contacts matches none of them
+    QHash<QString, QString>::iterator i = suffixes.find(suffix);
+    if (i == suffixes.end())
+        suffixes.insert(suffix, name);
+    else if (i.value() != name)
+        i.value() = QString();
+}
+
+QString OfonoContactIndex::matchSuffix(const QString &key)
+{
+    QString digits = key;
+    if (digits.startsWith('+'))
+        digits.remove(0, 1);
+    // service codes are matched exactly
+    if (digits.length() < CONTACT_MATCH_DIGITS || digits.contains('*') || digits.contains('#'))
+        return QString();
+    return digits.right(CONTACT_MATCH_DIGITS);
+}
+
+void OfonoContactIndex::resolve(const QString &call, const QString &number)
+{
+    QString name = lookup(number);
+    if (name.isEmpty()) {
+        m_names.remove(call);
+        m_unresolved.insert(call, number);
+        return;
+    }
+    m_unresolved.remove(call);
+    m_names.insert(call, name);
+    emit callerIdentified(call, number, name);
+}
+
+void OfonoContactIndex::callAdded(const QString &call, const QVariantMap &values)
+{
+    if (!isIncoming(values["State"].value<QString>()))
+        return;
+
+    // the manager creates its call object before callAdded()
+    OfonoVoiceCall *object = m_manager ? m_manager->call(call) : 0;
+    if (object)
+        connect(object, SIGNAL(lineIdentificationChanged(const QString&)),
+                this, SLOT(lineIdentificationChanged(const QString&)));
+    resolve(call, values["LineIdentification"].value<QString>());
+}
+
+void OfonoContactIndex::callRemoved(const QString &call)
+{
+    m_names.remove(call);
+    m_unresolved.remove(call);
+}
+
+void OfonoContactIndex::lineIdentificationChanged(const QString &number)
+{
+    OfonoVoiceCall *call = qobject_cast<OfonoVoiceCall*>(sender());
+    if (!call)
+        return;
+    QString path = call->path();
+    if (m_unresolved.contains(path)
+        || (m_names.contains(path) && m_names.value(path) != lookup(number)))
+        resolve(path, number);
+}
+
+void OfonoContactIndex::importComplete(bool success, const QString &entries)
+{
+    if (success)
+        load(entries);
+}
+
+void OfonoContactIndex::phonebookValidityChanged(bool validity)
+{
+    if (validity && m_phonebook)
+        m_phonebook->import();
+}
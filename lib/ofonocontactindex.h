@@ -0,0 +1,137 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOCONTACTINDEX_H
+#define OFONOCONTACTINDEX_H
+
+#include <QtCore/QObject>
+#include <QCache>
+#include <QHash>
+#include <QPointer>
+#include <QStringList>
+#include <QVariant>
+
+#include "libofono-qt_global.h"
+
+class QTimer;
+class OfonoVoiceCallManager;
+class OfonoPhonebook;
+
+//! Resolves the names of incoming callers from a local contact index
+/*!
+ * The index maps phone numbers to contact names. It is filled from vCard
+ * text, such as the entries reported by OfonoPhonebook::importComplete(),
+ * either by load() or by following a phonebook with setPhonebook().
+ *
+ * When the voice call manager adds an incoming or waiting call, the
+ * LineIdentification of the call is looked up right away, and
+ * callerIdentified() is issued from the same callAdded() emission, so a
+ * user interface that shows the call can show the name too. Numbers are
+ * normalized as in OfonoCallHistory::normalizeNumber(); a number that has
+ * no exact match is matched on its last seven digits, so that national and
+ * international forms of a number find each other, unless those digits
+ * belong to more than one contact.
+ *
+ * Loading does not block: the vCards are parsed a few at a time from the
+ * event loop, and the new index replaces the old one only when it is
+ * complete, so calls that arrive meanwhile are resolved from the old one.
+ * Calls that could not be resolved are retried when loading finishes and
+ * when their LineIdentification changes. Lookup results, including misses,
+ * are kept in a cache of at most cacheSize() numbers.
+ */
+class OFONO_QT_EXPORT OfonoContactIndex : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY loaded)
+    Q_PROPERTY(bool loading READ isLoading)
+
+public:
+    explicit OfonoContactIndex(OfonoVoiceCallManager *manager, QObject *parent=0);
+    ~OfonoContactIndex();
+
+    //! Loads the index from a phonebook, now and whenever it is imported
+    /*!
+     * The phonebook is imported when it is or becomes valid; call
+     * OfonoPhonebook::import() to refresh the index later.
+     */
+    void setPhonebook(OfonoPhonebook *phonebook);
+
+    //! Adds one number to the index
+    void insert(const QString &number, const QString &name);
+    void clear();
+
+    //! Returns the number of numbers in the index
+    int count() const {return m_numbers.count();}
+    bool isLoading() const;
+
+    //! Returns the name of the contact with a number, or an empty string
+    QString lookup(const QString &number) const;
+
+    //! Returns the resolved name of a current incoming call, or an empty string
+    QString callerName(const QString &call) const {return m_names.value(call);}
+
+    int cacheSize() const {return m_cache.maxCost();}
+    void setCacheSize(int size) {m_cache.setMaxCost(size);}
+
+public Q_SLOTS:
+    //! Replaces the index with the contacts in vCard text
+    /*!
+     * loaded() is issued when the new index is in use.
+     */
+    void load(const QString &vcards);
+
+Q_SIGNALS:
+    void loaded(int count);
+    void callerIdentified(const QString &call, const QString &number, const QString &name);
+
+private Q_SLOTS:
+    void callAdded(const QString &call, const QVariantMap &values);
+    void callRemoved(const QString &call);
+    void lineIdentificationChanged(const QString &number);
+    void importComplete(bool success, const QString &entries);
+    void phonebookValidityChanged(bool validity);
+    void loadNext();
+
+private:
+    static void addNumber(QHash<QString, QString> &numbers, QHash<QString, QString> &suffixes,
+                          const QString &number, const QString &name);
+    static QString matchSuffix(const QString &key);
+    void parseCard(const QStringList &lines);
+    void resolve(const QString &call, const QString &number);
+
+    QPointer<OfonoVoiceCallManager> m_manager;
+    QPointer<OfonoPhonebook> m_phonebook;
+    QHash<QString, QString> m_numbers;
+    QHash<QString, QString> m_suffixes;
+    mutable QCache<QString, QString> m_cache;
+    QHash<QString, QString> m_names;
+    QHash<QString, QString> m_unresolved;
+    QTimer *m_loadTimer;
+    QStringList m_lines;
+    int m_linePos;
+    QHash<QString, QString> m_loadNumbers;
+    QHash<QString, QString> m_loadSuffixes;
+};
+
+#endif // OFONOCONTACTINDEX_H
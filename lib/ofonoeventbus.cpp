@@ -0,0 +1,273 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtCore/QObject>
+#include <QMutex>
+#include <QStringList>
+
+#include "ofonoeventbus.h"
+#include "ofonoeventqueue.h"
+
+#define DEFAULT_CAPACITY 4096
+
+static QMutex propertyIdMutex;
+static QHash<QString, quint16> propertyIds;
+static QStringList propertyNames = QStringList() << QString();
+
+OfonoEventBus *OfonoEventBus::instance()
+{
+    static OfonoEventBus *bus = 0;
+    if (!bus)
+        bus = new OfonoEventBus();
+    return bus;
+}
+
+OfonoEventBus::OfonoEventBus()
+    : QObject(0), m_enabled(false), m_capacity(DEFAULT_CAPACITY), m_dropped(0)
+{
+    qRegisterMetaType<OfonoEvent>("OfonoEvent");
+    m_clock.start();
+}
+
+OfonoEventBus::~OfonoEventBus()
+{
+}
+
+void OfonoEventBus::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!isActive())
+        resetState();
+}
+
+void OfonoEventBus::attachQueue(OfonoEventQueue *queue)
+{
+    if (queue && !m_queues.contains(queue))
+        m_queues << queue;
+}
+
+void OfonoEventBus::detachQueue(OfonoEventQueue *queue)
+{
+    m_queues.removeAll(queue);
+    if (!isActive())
+        resetState();
+}
+
+void OfonoEventBus::resetState()
+{
+    m_lastValues.clear();
+    m_liveObjects.clear();
+}
+
+void OfonoEventBus::setCapacity(int capacity)
+{
+    m_capacity = qMax(capacity, 1);
+    while (m_events.count() > m_capacity) {
+        m_events.removeFirst();
+        m_dropped++;
+    }
+}
+
+QVector<OfonoEvent> OfonoEventBus::takeEvents(int max)
+{
+    int count = (max < 0 || max > m_events.count()) ? m_events.count() : max;
+    QVector<OfonoEvent> events;
+    events.reserve(count);
+    for (int i = 0; i < count; i++)
+        events.append(m_events.takeFirst());
+    return events;
+}
+
+quint16 OfonoEventBus::propertyId(const QString &name)
+{
+    QMutexLocker locker(&propertyIdMutex);
+    quint16 id = propertyIds.value(name);
+    if (id == 0 && propertyNames.count() <= 0xffff) {
+        id = propertyNames.count();
+        propertyNames << name;
+        propertyIds.insert(name, id);
+    }
+    return id;
+}
+
+QString OfonoEventBus::propertyName(quint16 id)
+{
+    QMutexLocker locker(&propertyIdMutex);
+    return propertyNames.value(id);
+}
+
+OfonoEvent::Interface OfonoEventBus::interfaceId(const QString &ifname)
+{
+    static QHash<QString, OfonoEvent::Interface> ids;
+    if (ids.isEmpty()) {
+        ids.insert("org.ofono.Manager", OfonoEvent::Manager);
+        ids.insert("org.ofono.Modem", OfonoEvent::Modem);
+        ids.insert("org.ofono.CallBarring", OfonoEvent::CallBarring);
+        ids.insert("org.ofono.CallForwarding", OfonoEvent::CallForwarding);
+        ids.insert("org.ofono.CallMeter", OfonoEvent::CallMeter);
+        ids.insert("org.ofono.CallSettings", OfonoEvent::CallSettings);
+        ids.insert("org.ofono.CallVolume", OfonoEvent::CallVolume);
+        ids.insert("org.ofono.CellBroadcast", OfonoEvent::CellBroadcast);
+        ids.insert("org.ofono.ConnectionManager", OfonoEvent::ConnectionManager);
+        ids.insert("org.ofono.ConnectionContext", OfonoEvent::ConnectionContext);
+        ids.insert("org.ofono.MessageManager", OfonoEvent::MessageManager);
+        ids.insert("org.ofono.Message", OfonoEvent::Message);
+        ids.insert("org.ofono.MessageWaiting", OfonoEvent::MessageWaiting);
+        ids.insert("org.ofono.NetworkRegistration", OfonoEvent::NetworkRegistration);
+        ids.insert("org.ofono.NetworkOperator", OfonoEvent::NetworkOperator);
+        ids.insert("org.ofono.Phonebook", OfonoEvent::Phonebook);
+        ids.insert("org.ofono.RadioSettings", OfonoEvent::RadioSettings);
+        ids.insert("org.ofono.SimManager", OfonoEvent::SimManager);
+        ids.insert("org.ofono.SupplementaryServices", OfonoEvent::SupplementaryServices);
+        ids.insert("org.ofono.VoiceCallManager", OfonoEvent::VoiceCallManager);
+        ids.insert("org.ofono.VoiceCall", OfonoEvent::VoiceCall);
+    }
+    return ids.value(ifname, OfonoEvent::UnknownInterface);
+}
+
+QString OfonoEventBus::modemPathOf(const QString &path, OfonoEvent::Interface iface)
+{
+    // calls, contexts and messages are children of the modem object,
+    // operators live under <modem>/operator/
+    switch (iface) {
+    case OfonoEvent::VoiceCall:
+    case OfonoEvent::ConnectionContext:
+    case OfonoEvent::Message:
+        return path.section('/', 0, -2);
+    case OfonoEvent::NetworkOperator:
+        return path.section('/', 0, -3);
+    case OfonoEvent::Manager:
+        return QString();
+    default:
+        return path;
+    }
+}
+
+void OfonoEventBus::publishProperty(const QString &path, const QString &ifname,
+                                    const QString &name, const QVariant &value)
+{
+    if (!isActive())
+        return;
+
+    QHash<QString, QVariant> &values = m_lastValues[path];
+    QString key = ifname + '\n' + name;
+    QHash<QString, QVariant>::iterator last = values.find(key);
+    if (last != values.end()) {
+        if (last.value() == value)
+            return;
+        last.value() = value;
+    } else {
+        values.insert(key, value);
+    }
+
+    OfonoEvent event;
+    event.type = OfonoEvent::PropertyChanged;
+    event.iface = interfaceId(ifname);
+    event.property = propertyId(name);
+    event.path = path;
+    event.modemPath = modemPathOf(path, OfonoEvent::Interface(event.iface));
+    event.value = value;
+    enqueue(event);
+}
+
+void OfonoEventBus::publish(OfonoEvent::Type type, const QString &path, const QString &ifname,
+                            const QVariant &value)
+{
+    if (!isActive())
+        return;
+
+    switch (type) {
+    case OfonoEvent::ModemAdded:
+    case OfonoEvent::CallAdded:
+    case OfonoEvent::ContextAdded:
+    case OfonoEvent::MessageAdded:
+        if (m_liveObjects.contains(path))
+            return;
+        m_liveObjects.insert(path);
+        break;
+    case OfonoEvent::ModemRemoved:
+    case OfonoEvent::CallRemoved:
+    case OfonoEvent::ContextRemoved:
+    case OfonoEvent::MessageRemoved:
+        // oFono reuses the paths of calls and contexts
+        forgetObject(path, type == OfonoEvent::ModemRemoved);
+        if (!m_liveObjects.remove(path))
+            return;
+        break;
+    default:
+        break;
+    }
+
+    OfonoEvent event;
+    event.type = type;
+    event.iface = interfaceId(ifname);
+    event.path = path;
+    event.modemPath = (type == OfonoEvent::ModemAdded || type == OfonoEvent::ModemRemoved)
+                      ? path : modemPathOf(path, OfonoEvent::Interface(event.iface));
+    event.value = value;
+    enqueue(event);
+}
+
+void OfonoEventBus::enqueue(const OfonoEvent &event)
+{
+    OfonoEvent stamped = event;
+    stamped.timestamp = m_clock.nsecsElapsed();
+    foreach (OfonoEventQueue *queue, m_queues)
+        queue->push(stamped);
+
+    if (!m_enabled)
+        return;
+
+    bool wasEmpty = m_events.isEmpty();
+    m_events.append(stamped);
+    if (m_events.count() > m_capacity) {
+        m_events.removeFirst();
+        m_dropped++;
+    }
+    if (wasEmpty)
+        emit eventsAvailable();
+}
+
+void OfonoEventBus::forgetObject(const QString &path, bool children)
+{
+    m_lastValues.remove(path);
+    if (!children)
+        return;
+
+    // the objects of a modem are only removed one by one while it exists
+    QString prefix = path + '/';
+    QHash<QString, QHash<QString, QVariant> >::iterator i = m_lastValues.begin();
+    while (i != m_lastValues.end()) {
+        if (i.key().startsWith(prefix))
+            i = m_lastValues.erase(i);
+        else
+            ++i;
+    }
+    QSet<QString>::iterator j = m_liveObjects.begin();
+    while (j != m_liveObjects.end()) {
+        if (j->startsWith(prefix))
+            j = m_liveObjects.erase(j);
+        else
+            ++j;
+    }
+}
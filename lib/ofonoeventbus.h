@@ -0,0 +1,203 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOEVENTBUS_H
+#define OFONOEVENTBUS_H
+
+#include <QtCore/QObject>
+#include <QVariant>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
+#include "libofono-qt_global.h"
+
+class OfonoEventQueue;
+
+//! A single change seen by the library
+struct OFONO_QT_EXPORT OfonoEvent
+{
+    //! Kind of change
+    enum Type {
+        PropertyChanged,    /*!< A property of an interface has changed */
+        ModemAdded,         /*!< A modem has appeared */
+        ModemRemoved,       /*!< A modem has disappeared */
+        CallAdded,          /*!< A voice call has been added */
+        CallRemoved,        /*!< A voice call has been removed */
+        MessageIncoming,    /*!< A text message has been received */
+        ContextAdded,       /*!< A connection context has been added */
+        ContextRemoved,     /*!< A connection context has been removed */
+        MessageAdded,       /*!< A text message has been queued for sending */
+        MessageRemoved      /*!< A queued text message has been removed */
+    };
+
+    //! oFono interface the change belongs to
+    enum Interface {
+        UnknownInterface,
+        Manager,
+        Modem,
+        CallBarring,
+        CallForwarding,
+        CallMeter,
+        CallSettings,
+        CallVolume,
+        CellBroadcast,
+        ConnectionManager,
+        ConnectionContext,
+        MessageManager,
+        Message,
+        MessageWaiting,
+        NetworkRegistration,
+        NetworkOperator,
+        Phonebook,
+        RadioSettings,
+        SimManager,
+        SupplementaryServices,
+        VoiceCallManager,
+        VoiceCall
+    };
+
+    OfonoEvent() : type(PropertyChanged), iface(UnknownInterface), property(0), timestamp(0) {}
+
+    quint8 type;        //!< an OfonoEvent::Type value
+    quint8 iface;       //!< an OfonoEvent::Interface value
+    quint16 property;   //!< property id, see OfonoEventBus::propertyName(); 0 if not a property change
+    qint64 timestamp;   //!< monotonic time of the change, in nanoseconds, see OfonoEventBus::timestamp()
+    QString modemPath;  //!< D-Bus path of the modem the change belongs to
+    QString path;       //!< D-Bus path of the object that has changed
+    /*!
+     * New property value for PropertyChanged, object properties for
+     * the Added events, a list of message text and message info for
+     * MessageIncoming, and invalid for the Removed events.
+     */
+    QVariant value;
+};
+Q_DECLARE_METATYPE(OfonoEvent)
+
+//! Publishes every change seen by the library as a single ordered event stream
+/*!
+ * The bus collects property changes of all interfaces, additions and
+ * removals of modems, calls, contexts and outgoing messages, and incoming
+ * messages into one queue of compact OfonoEvent records. Consumers drain the queue in batches
+ * with takeEvents(), typically when eventsAvailable() is issued.
+ *
+ * Several wrapper objects for the same D-Bus object see the same changes;
+ * the bus publishes each change once.
+ *
+ * Consumers in worker threads attach an OfonoEventQueue instead, and pop
+ * events from it without locks and without an event loop. Attached queues
+ * receive events whether or not the bus itself is enabled.
+ *
+ * The bus is disabled by default and then, with no queues attached, costs a
+ * single check per change. Except for popping from attached queues, it must
+ * be used from the thread in which the library objects live.
+ */
+class OFONO_QT_EXPORT OfonoEventBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Returns the process-wide event bus
+    static OfonoEventBus *instance();
+
+    //! Enables or disables event collection into the queue returned by takeEvents()
+    void setEnabled(bool enabled);
+    bool isEnabled() const {return m_enabled;}
+
+    //! Sets the maximum number of queued events
+    /*!
+     * When the queue is full, the oldest events are dropped. The default
+     * capacity is 4096 events.
+     */
+    void setCapacity(int capacity);
+    int capacity() const {return m_capacity;}
+
+    //! Removes and returns up to \a max queued events, oldest first
+    /*!
+     * If \a max is negative, all queued events are returned.
+     */
+    QVector<OfonoEvent> takeEvents(int max = -1);
+
+    //! Returns the number of queued events
+    int pendingCount() const {return m_events.count();}
+
+    //! Returns the number of events dropped because the queue was full
+    quint64 droppedCount() const {return m_dropped;}
+
+    //! Returns the current monotonic time, in nanoseconds, as used for event timestamps
+    qint64 timestamp() const {return m_clock.nsecsElapsed();}
+
+    //! Returns the id of a property name, registering it if necessary
+    static quint16 propertyId(const QString &name);
+
+    //! Returns the property name for an id returned by propertyId()
+    static QString propertyName(quint16 id);
+
+    //! Returns the interface enum value for a D-Bus interface name
+    static OfonoEvent::Interface interfaceId(const QString &ifname);
+
+    //! Starts delivering events to \a queue
+    /*!
+     * The queue must stay alive until it is detached.
+     */
+    void attachQueue(OfonoEventQueue *queue);
+
+    //! Stops delivering events to \a queue
+    void detachQueue(OfonoEventQueue *queue);
+
+    //! Publishes a property change
+    void publishProperty(const QString &path, const QString &ifname,
+                         const QString &name, const QVariant &value);
+
+    //! Publishes an event other than a property change
+    void publish(OfonoEvent::Type type, const QString &path, const QString &ifname,
+                 const QVariant &value = QVariant());
+
+Q_SIGNALS:
+    //! Issued when the queue becomes non-empty
+    void eventsAvailable();
+
+private:
+    OfonoEventBus();
+    ~OfonoEventBus();
+
+    bool isActive() const {return m_enabled || !m_queues.isEmpty();}
+    void resetState();
+    static QString modemPathOf(const QString &path, OfonoEvent::Interface iface);
+    void enqueue(const OfonoEvent &event);
+    void forgetObject(const QString &path, bool children);
+
+private:
+    bool m_enabled;
+    int m_capacity;
+    quint64 m_dropped;
+    QElapsedTimer m_clock;
+    QList<OfonoEvent> m_events;
+    QList<OfonoEventQueue *> m_queues;
+    // the last published values per object path, by interface and name
+    QHash<QString, QHash<QString, QVariant> > m_lastValues;
+    QSet<QString> m_liveObjects;
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "ofonoeventqueue.h"
+
+// Each cell carries a sequence number telling whose turn it is: a cell at
+// position pos is free for the producer when sequence == pos, and holds an
+// event for the consumers when sequence == pos + 1. A consumer claims a cell
+// by advancing the shared tail, and frees it for the next lap by setting the
+// sequence to pos + capacity. Positions wrap around, so they are compared as
+// signed differences.
+
+OfonoEventQueue::OfonoEventQueue(int capacity)
+    : m_head(0), m_dropped(0), m_tail(0)
+{
+    quint32 size = 2;
+    while (size < quint32(qMax(capacity, 2)) && size < 0x40000000)
+        size <<= 1;
+    m_mask = size - 1;
+    m_cells = new Cell[size];
+    for (quint32 i = 0; i < size; i++)
+        m_cells[i].sequence.store(i);
+}
+
+OfonoEventQueue::~OfonoEventQueue()
+{
+    delete[] m_cells;
+}
+
+bool OfonoEventQueue::push(const OfonoEvent &event)
+{
+    Cell &cell = m_cells[m_head & m_mask];
+    if (qint32(cell.sequence.loadAcquire() - m_head) < 0) {
+        // a consumer has not finished with this cell yet
+        m_dropped.fetchAndAddRelaxed(1);
+        return false;
+    }
+    cell.event = event;
+    cell.sequence.storeRelease(m_head + 1);
+    m_head++;
+    return true;
+}
+
+bool OfonoEventQueue::pop(OfonoEvent &event)
+{
+    quint32 pos = m_tail.load();
+    for (;;) {
+        Cell &cell = m_cells[pos & m_mask];
+        qint32 diff = qint32(cell.sequence.loadAcquire() - (pos + 1));
+        if (diff == 0) {
+            if (m_tail.testAndSetRelaxed(pos, pos + 1)) {
+                event = cell.event;
+                cell.event = OfonoEvent();
+                cell.sequence.storeRelease(pos + m_mask + 1);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        }
+        pos = m_tail.load();
+    }
+}
+
+int OfonoEventQueue::popBatch(QVector<OfonoEvent> &events, int max)
+{
+    int count = 0;
+    OfonoEvent event;
+    while (count < max && pop(event)) {
+        events.append(event);
+        count++;
+    }
+    return count;
+}
+
+bool OfonoEventQueue::isEmpty() const
+{
+    quint32 pos = m_tail.load();
+    return qint32(m_cells[pos & m_mask].sequence.loadAcquire() - (pos + 1)) < 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOEVENTQUEUE_H
+#define OFONOEVENTQUEUE_H
+
+#include <QAtomicInteger>
+#include <QVector>
+#include "ofonoeventbus.h"
+#include "libofono-qt_global.h"
+
+//! A bounded lock-free queue of events for consumers in worker threads
+/*!
+ * An event queue attached with OfonoEventBus::attachQueue() receives every
+ * event published by the bus. The bus is the only producer and pushes from
+ * the thread in which the library objects live; any number of worker threads
+ * may pop events concurrently without locks and without an event loop.
+ *
+ * When the queue is full, new events are dropped and counted in droppedCount().
+ * Consumers that cannot keep up should increase the capacity rather than rely
+ * on every event being delivered.
+ */
+class OFONO_QT_EXPORT OfonoEventQueue
+{
+public:
+    //! Creates a queue holding at least \a capacity events, rounded up to a power of two
+    explicit OfonoEventQueue(int capacity = 1024);
+    ~OfonoEventQueue();
+
+    int capacity() const {return m_mask + 1;}
+
+    //! Appends an event, returns false if the queue is full
+    /*!
+     * Must only be called from a single producer thread.
+     */
+    bool push(const OfonoEvent &event);
+
+    //! Removes the oldest event into \a event, returns false if the queue is empty
+    /*!
+     * May be called from any number of threads.
+     */
+    bool pop(OfonoEvent &event);
+
+    //! Removes up to \a max events, oldest first, and appends them to \a events
+    /*!
+     * Returns the number of events removed. May be called from any number of threads.
+     */
+    int popBatch(QVector<OfonoEvent> &events, int max);
+
+    //! Returns true if the queue held no events at the time of the call
+    bool isEmpty() const;
+
+    //! Returns the number of events dropped because the queue was full
+    quint32 droppedCount() const {return m_dropped.loadAcquire();}
+
+private:
+    Q_DISABLE_COPY(OfonoEventQueue)
+
+    struct Cell {
+        QAtomicInteger<quint32> sequence;
+        OfonoEvent event;
+    };
+
+    Cell *m_cells;
+    quint32 m_mask;
+    // producer and consumer positions are kept on separate cache lines
+    char m_pad0[64];
+    quint32 m_head;
+    QAtomicInteger<quint32> m_dropped;
+    char m_pad1[64];
+    QAtomicInteger<quint32> m_tail;
+    char m_pad2[64];
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtDBus/QtDBus>
+#include <QtCore/QObject>
+
+#include "ofonofederatedmodemmanager.h"
+#include "ofonomodemmanager.h"
+
+OfonoFederatedModemManager::OfonoFederatedModemManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+OfonoFederatedModemManager::~OfonoFederatedModemManager()
+{
+    qDeleteAll(m_sources);
+}
+
+bool OfonoFederatedModemManager::addSource(const QString& name, const OfonoConnection& connection)
+{
+    if (name.isEmpty() || name.contains(':') || m_sources.contains(name))
+        return false;
+
+    Source *source = new Source;
+    source->connection = connection;
+    source->available = false;
+    source->failures = 0;
+    source->changed = QDateTime::currentDateTime();
+    source->watcher = new QDBusServiceWatcher(connection.service(), connection.bus(),
+                                              QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(source->watcher, SIGNAL(serviceOwnerChanged(const QString&, const QString&, const QString&)),
+            this, SLOT(onServiceOwnerChanged(const QString&, const QString&, const QString&)));
+    m_sources.insert(name, source);
+    m_sourceNames << name;
+
+    // the manager is kept while the source comes and goes, and enumerates
+    // the modems again without blocking when oFono returns
+    {
+        OfonoConnectionScope scope(connection);
+        source->manager = new OfonoModemManager(this);
+    }
+    connect(source->manager, SIGNAL(modemAdded(const QString&)),
+            this, SLOT(onModemAdded(const QString&)));
+    connect(source->manager, SIGNAL(modemRemoved(const QString&)),
+            this, SLOT(onModemRemoved(const QString&)));
+    foreach (QString path, source->manager->modems())
+        addModem(source, modemId(name, path));
+
+    // peer-to-peer connections have no bus daemon to ask
+    QDBusConnectionInterface *daemon = connection.bus().interface();
+    if (daemon ? daemon->isServiceRegistered(connection.service()).value()
+               : connection.bus().isConnected())
+        setAvailable(name, true);
+    return true;
+}
+
+void OfonoFederatedModemManager::removeSource(const QString& name)
+{
+    if (!m_sources.contains(name))
+        return;
+    // a source that is removed on purpose has not failed
+    Source *source = m_sources.value(name);
+    if (source->available) {
+        source->available = false;
+        dropModems(source);
+        emit sourceAvailabilityChanged(name, false);
+    }
+    m_sources.remove(name);
+    m_sourceNames.removeAll(name);
+    delete source->manager;
+    delete source->watcher;
+    delete source;
+}
+
+void OfonoFederatedModemManager::setAvailable(const QString& name, bool available)
+{
+    Source *source = m_sources.value(name);
+    if (source->available == available)
+        return;
+    source->available = available;
+    source->changed = QDateTime::currentDateTime();
+
+    // the modems of a returning source are added as the manager finds them
+    if (!available) {
+        source->failures++;
+        dropModems(source);
+    }
+    emit sourceAvailabilityChanged(name, available);
+}
+
+void OfonoFederatedModemManager::addModem(Source *source, const QString &id)
+{
+    if (source->modems.contains(id))
+        return;
+    source->modems << id;
+    emit modemAdded(id);
+}
+
+void OfonoFederatedModemManager::dropModems(Source *source)
+{
+    // the manager reports the modems as removed too, unless it has already
+    QStringList removed = source->modems;
+    source->modems.clear();
+    foreach (QString id, removed)
+        emit modemRemoved(id);
+}
+
+QString OfonoFederatedModemManager::sourceOfSender() const
+{
+    QObject *object = sender();
+    for (QHash<QString, Source*>::const_iterator i = m_sources.begin(); i != m_sources.end(); ++i) {
+        if (i.value()->manager == object || i.value()->watcher == object)
+            return i.key();
+    }
+    return QString();
+}
+
+void OfonoFederatedModemManager::onModemAdded(const QString& path)
+{
+    QString name = sourceOfSender();
+    if (name.isEmpty())
+        return;
+    addModem(m_sources.value(name), modemId(name, path));
+}
+
+void OfonoFederatedModemManager::onModemRemoved(const QString& path)
+{
+    QString name = sourceOfSender();
+    if (name.isEmpty())
+        return;
+    QString id = modemId(name, path);
+    if (m_sources.value(name)->modems.removeAll(id) > 0)
+        emit modemRemoved(id);
+}
+
+void OfonoFederatedModemManager::onServiceOwnerChanged(const QString& /*service*/,
+                                                       const QString& oldOwner, const QString& newOwner)
+{
+    QString name = sourceOfSender();
+    if (name.isEmpty())
+        return;
+    // a restarted daemon may take over the name without a gap
+    if (!oldOwner.isEmpty())
+        setAvailable(name, false);
+    if (!newOwner.isEmpty())
+        setAvailable(name, true);
+}
+
+OfonoConnection OfonoFederatedModemManager::connection(const QString& source) const
+{
+    Source *s = m_sources.value(source);
+    return s ? s->connection : OfonoConnection();
+}
+
+bool OfonoFederatedModemManager::isSourceAvailable(const QString& source) const
+{
+    Source *s = m_sources.value(source);
+    return s && s->available;
+}
+
+QDateTime OfonoFederatedModemManager::sourceChangedTime(const QString& source) const
+{
+    Source *s = m_sources.value(source);
+    return s ? s->changed : QDateTime();
+}
+
+int OfonoFederatedModemManager::sourceFailures(const QString& source) const
+{
+    Source *s = m_sources.value(source);
+    return s ? s->failures : 0;
+}
+
+QStringList OfonoFederatedModemManager::modems(const QString& source) const
+{
+    Source *s = m_sources.value(source);
+    return s ? s->modems : QStringList();
+}
+
+QStringList OfonoFederatedModemManager::modems() const
+{
+    QStringList result;
+    foreach (QString name, m_sourceNames)
+        result << m_sources.value(name)->modems;
+    return result;
+}
+
+QString OfonoFederatedModemManager::sourceOf(const QString& modemId)
+{
+    return modemId.section(':', 0, 0);
+}
+
+QString OfonoFederatedModemManager::pathOf(const QString& modemId)
+{
+    return modemId.section(':', 1);
+}
+
+QString OfonoFederatedModemManager::modemId(const QString& source, const QString& path)
+{
+    return source + ':' + path;
+}
@@ -0,0 +1,143 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOFEDERATEDMODEMMANAGER_H
+#define OFONOFEDERATEDMODEMMANAGER_H
+
+#include <QtCore/QObject>
+#include <QStringList>
+#include <QHash>
+#include <QDateTime>
+#include "ofonoconnection.h"
+#include "libofono-qt_global.h"
+
+class OfonoModemManager;
+class QDBusServiceWatcher;
+
+//! Provides one merged list of the modems of several oFono instances
+/*!
+ * Each oFono instance is added as a named source with the connection used
+ * to reach it, see OfonoConnection. Modems are identified by ids of the form
+ * "source:path", for example "rack1:/phonesim".
+ *
+ * Sources are watched on their bus: when an oFono instance goes away, its
+ * modems are removed from the list and the source is marked unavailable;
+ * when it comes back, its modems are enumerated again in the background and
+ * modemAdded() is issued for each of them.
+ *
+ * Any modem or modem interface class can be created for a modem of a source:
+ *
+ * \code
+ * OfonoConnectionScope scope(federation->connection(OfonoFederatedModemManager::sourceOf(id)));
+ * OfonoSimManager *sim = new OfonoSimManager(OfonoModem::ManualSelect,
+ *                                            OfonoFederatedModemManager::pathOf(id));
+ * \endcode
+ */
+class OFONO_QT_EXPORT OfonoFederatedModemManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    OfonoFederatedModemManager(QObject *parent=0);
+    ~OfonoFederatedModemManager();
+
+    //! Adds an oFono instance as a source
+    /*!
+     * The name must be unique and must not contain ':'. Returns false if
+     * the source could not be added.
+     */
+    bool addSource(const QString &name, const OfonoConnection &connection);
+
+    //! Removes a source; its modems are reported as removed
+    /*!
+     * Removing a source does not count as a failure, see sourceFailures().
+     */
+    void removeSource(const QString &name);
+
+    //! Returns the source names in the order they were added
+    QStringList sources() const {return m_sourceNames;}
+
+    //! Returns the connection of a source
+    OfonoConnection connection(const QString &source) const;
+
+    //! Returns true if the oFono instance of a source is currently reachable
+    bool isSourceAvailable(const QString &source) const;
+
+    //! Returns the time the availability of a source last changed
+    QDateTime sourceChangedTime(const QString &source) const;
+
+    //! Returns how many times a source has become unavailable since it was added
+    int sourceFailures(const QString &source) const;
+
+    //! Returns the ids of the modems of one source
+    QStringList modems(const QString &source) const;
+
+    //! Returns the ids of the modems of all sources
+    Q_INVOKABLE QStringList modems() const;
+
+    //! Returns the source name of a modem id
+    static QString sourceOf(const QString &modemId);
+
+    //! Returns the D-Bus object path of a modem id
+    static QString pathOf(const QString &modemId);
+
+    //! Returns the modem id for a D-Bus object path of a source
+    static QString modemId(const QString &source, const QString &path);
+
+Q_SIGNALS:
+    //! Issued when a modem has been added
+    void modemAdded(const QString &modemId);
+
+    //! Issued when a modem has been removed
+    void modemRemoved(const QString &modemId);
+
+    //! Issued when the oFono instance of a source has appeared or disappeared
+    void sourceAvailabilityChanged(const QString &source, bool available);
+
+private Q_SLOTS:
+    void onModemAdded(const QString &path);
+    void onModemRemoved(const QString &path);
+    void onServiceOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner);
+
+private:
+    struct Source {
+        OfonoConnection connection;
+        OfonoModemManager *manager;
+        QDBusServiceWatcher *watcher;
+        bool available;
+        QDateTime changed;
+        int failures;
+        QStringList modems;
+    };
+
+    void setAvailable(const QString &name, bool available);
+    void addModem(Source *source, const QString &id);
+    void dropModems(Source *source);
+    QString sourceOfSender() const;
+
+private:
+    QStringList m_sourceNames;
+    QHash<QString, Source*> m_sources;
+};
+
+#endif
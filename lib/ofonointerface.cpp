@@ -25,51 +25,203 @@
 #include <QtCore/QObject>
 
 #include "ofonointerface.h"
+#include "ofonointerface_p.h"
+#include "ofonoiothread.h"
+#include "ofonoservicetracker.h"
+#include "ofonopropertycache.h"
+#include "ofonoeventbus.h"
 
 #define GET_PROPERTIES_TIMEOUT 300000
 #define SET_PROPERTY_TIMEOUT 300000
 
 OfonoInterface::OfonoInterface(const QString& path, const QString& ifname, OfonoGetPropertySetting setting, QObject *parent)
-    : QObject(parent) , m_path(path), m_ifname(ifname), m_getpropsetting(setting)
+    : QObject(parent) , m_connection(OfonoConnection::current()), m_path(path), m_ifname(ifname), m_getpropsetting(setting), m_lastTriggerId(0),
+      m_lastCallbackHandle(0), m_state(new OfonoInterfaceState(path)), m_receiver(0),
+      m_resyncWatcher(0), m_stale(false)
 {
-    QDBusConnection::systemBus().connect("org.ofono", path, ifname, 
-					     "PropertyChanged",
-					     this,
-					     SLOT(onPropertyChanged(QString, QDBusVariant)));
+    if (OfonoIoThread::isEnabled()) {
+        m_receiver = new OfonoInterfaceReceiver(m_state);
+        m_receiver->moveToThread(OfonoIoThread::thread());
+        connect(m_receiver, SIGNAL(propertyUpdated(const QString&, const QString&, const QVariant&)),
+                this, SLOT(onPropertyUpdated(const QString&, const QString&, const QVariant&)));
+    }
+    connectPropertyChanged();
+    m_tracker = OfonoServiceTracker::forConnection(m_connection);
+    connect(m_tracker, SIGNAL(serviceLost()), this, SLOT(onServiceLost()));
+    connect(m_tracker, SIGNAL(serviceReturned()), this, SLOT(onServiceReturned()));
     if (setting == OfonoGetAllOnStartup && path != "/")
-        m_properties = getAllPropertiesSync();
+        storeProperties(getAllPropertiesSync());
 }
 
 OfonoInterface::~OfonoInterface()
 {
+    if (m_receiver) {
+        disconnectPropertyChanged();
+        m_receiver->deleteLater();
+    }
 }
 
-void OfonoInterface::setPath(const QString& path)
+void OfonoInterface::connectPropertyChanged()
 {
-    QDBusConnection::systemBus().disconnect("org.ofono", m_path, m_ifname, 
+    // with the I/O thread enabled, the receiver updates the cache and
+    // forwards the change to onPropertyUpdated()
+    QObject *receiver = m_receiver ? static_cast<QObject*>(m_receiver) : this;
+    m_connection.bus().connect(m_connection.service(), m_path, m_ifname, 
 					     "PropertyChanged",
-					     this,
+					     receiver,
 					     SLOT(onPropertyChanged(QString, QDBusVariant)));
-    m_path = path;
-    QDBusConnection::systemBus().connect("org.ofono", m_path, m_ifname, 
+}
+
+void OfonoInterface::disconnectPropertyChanged()
+{
+    QObject *receiver = m_receiver ? static_cast<QObject*>(m_receiver) : this;
+    m_connection.bus().disconnect(m_connection.service(), m_path, m_ifname, 
 					     "PropertyChanged",
-					     this,
+					     receiver,
 					     SLOT(onPropertyChanged(QString, QDBusVariant)));
+}
 
+void OfonoInterface::setPath(const QString& path)
+{
+    switchPath(path);
     if (m_getpropsetting == OfonoGetAllOnStartup)
-        m_properties = getAllPropertiesSync();
-    else
-    	resetProperties();
+        storeProperties(getAllPropertiesSync());
+}
+
+void OfonoInterface::setPathAsync(const QString& path)
+{
+    switchPath(path);
+    if (m_getpropsetting != OfonoGetAllOnStartup || path == "/") {
+        emit propertiesReady(path, true);
+        return;
+    }
+
+    QVariantMap map;
+    if (!fetchCachedProperties(map, false)) {
+        fetchPropertiesAsync();
+        return;
+    }
+    storeProperties(map);
+    foreach (QString property, map.keys())
+        notifyPropertyChanged(property, map[property]);
+    emit propertiesReady(path, true);
+}
+
+void OfonoInterface::switchPath(const QString& path)
+{
+    cancelResync();
+    clearStale();
+    disconnectPropertyChanged();
+    m_path = path;
+    {
+        QMutexLocker locker(&m_state->writeLock);
+        m_state->publish(path, QVariantMap());
+    }
+    for (QMap<int, OfonoPropertyTrigger>::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+        i.value().reset();
+    connectPropertyChanged();
 }
 
 QVariantMap OfonoInterface::properties() const
 {
-    return m_properties;
+    return m_state->load()->properties;
+}
+
+OfonoPropertySnapshot OfonoInterface::snapshot() const
+{
+    return OfonoPropertySnapshot(m_state->load());
+}
+
+void OfonoInterface::onServiceLost()
+{
+    cancelResync();
+    clearStale();
+    resetProperties();
+    for (QMap<int, OfonoPropertyTrigger>::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+        i.value().reset();
+}
+
+void OfonoInterface::onServiceReturned()
+{
+    if (m_getpropsetting != OfonoGetAllOnStartup || m_path == "/")
+        return;
+    fetchPropertiesAsync();
+}
+
+void OfonoInterface::fetchPropertiesAsync()
+{
+    // the reply to an earlier restart is out of date
+    cancelResync();
+    QDBusMessage request = QDBusMessage::createMethodCall(m_connection.service(),
+                                                          m_path, m_ifname,
+                                                          "GetProperties");
+    m_resyncWatcher = new QDBusPendingCallWatcher(m_connection.bus().asyncCall(request, GET_PROPERTIES_TIMEOUT), this);
+    connect(m_resyncWatcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(resyncPropertiesFinished(QDBusPendingCallWatcher*)));
+    m_tracker->addFetch(m_resyncWatcher);
+}
+
+void OfonoInterface::resyncPropertiesFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    m_resyncWatcher = 0;
+    watcher->deleteLater();
+
+    if (!reply.isError()) {
+        QVariantMap map = reply.value();
+        storeProperties(map);
+        foreach (QString property, map.keys())
+            notifyPropertyChanged(property, map[property]);
+    }
+    emit propertiesReady(m_path, !reply.isError());
+}
+
+void OfonoInterface::cancelResync()
+{
+    if (!m_resyncWatcher)
+        return;
+    delete m_resyncWatcher;
+    m_resyncWatcher = 0;
+}
+
+void OfonoInterface::onReconciled(const QString &path, const QString &ifname, const QVariantMap &changed)
+{
+    if (path != m_path || ifname != m_ifname)
+        return;
+    clearStale();
+
+    if (!OfonoPropertyCache::forConnection(m_connection)->contains(path, ifname)) {
+        // the interface has gone away while the application was not running
+        resetProperties();
+        return;
+    }
+    {
+        QMutexLocker locker(&m_state->writeLock);
+        for (QVariantMap::const_iterator i = changed.begin(); i != changed.end(); ++i)
+            m_state->publishProperty(i.key(), i.value());
+    }
+    for (QVariantMap::const_iterator i = changed.begin(); i != changed.end(); ++i)
+        notifyPropertyChanged(i.key(), i.value());
+}
+
+void OfonoInterface::clearStale()
+{
+    if (!m_stale)
+        return;
+    m_stale = false;
+    disconnect(OfonoPropertyCache::forConnection(m_connection), SIGNAL(reconciled(const QString&, const QString&, const QVariantMap&)),
+               this, SLOT(onReconciled(const QString&, const QString&, const QVariantMap&)));
 }
 
 void OfonoInterface::resetProperties()
 {
-    m_properties = QVariantMap();
+    storeProperties(QVariantMap());
+}
+
+void OfonoInterface::storeProperties(const QVariantMap& properties)
+{
+    QMutexLocker locker(&m_state->writeLock);
+    m_state->publish(m_path, properties);
 }
 
 QVariantMap OfonoInterface::getAllPropertiesSync()
@@ -78,17 +230,35 @@ QVariantMap OfonoInterface::getAllPropertiesSync()
     QVariantMap map;
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
-                                             m_path, m_ifname,
-                                             "GetProperties");
-    reply = QDBusConnection::systemBus().call(request);
-    map = reply;
+    // warmed up, seeded or loaded properties save the round trip
+    if (!fetchCachedProperties(map, true)) {
+        request = QDBusMessage::createMethodCall(m_connection.service(),
+                                                 m_path, m_ifname,
+                                                 "GetProperties");
+        reply = m_connection.bus().call(request);
+        map = reply;
+    }
     foreach (QString property, map.keys()) {
-        emit propertyChanged(property, map[property]);
+        notifyPropertyChanged(property, map[property]);
     }
     return map;
 }
 
+bool OfonoInterface::fetchCachedProperties(QVariantMap &properties, bool wait)
+{
+    OfonoPropertyCache *cache = OfonoPropertyCache::forConnection(m_connection);
+    // an entry that is still being fetched is not in the cache yet
+    if (!wait && !cache->contains(m_path, m_ifname))
+        return false;
+    if (!cache->fetch(m_path, m_ifname, properties, &m_stale))
+        return false;
+    if (m_stale)
+        connect(cache, SIGNAL(reconciled(const QString&, const QString&, const QVariantMap&)),
+                this, SLOT(onReconciled(const QString&, const QString&, const QVariantMap&)),
+                Qt::UniqueConnection);
+    return true;
+}
+
 void OfonoInterface::requestProperty(const QString& name)
 {
     if (m_pendingProperty.length() > 0) {
@@ -98,18 +268,19 @@ void OfonoInterface::requestProperty(const QString& name)
         return;
     }
     
-    if (m_properties.keys().contains(name)) {
-        emit requestPropertyComplete(true, name, m_properties[name]);
+    QVariantMap cached = properties();
+    if (cached.contains(name)) {
+        emit requestPropertyComplete(true, name, cached[name]);
         return;
     }
     
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_connection.service(),
 					     m_path, m_ifname,
 					     "GetProperties");
 
-    bool result = QDBusConnection::systemBus().callWithCallback(request, this,
+    bool result = m_connection.bus().callWithCallback(request, this,
 					SLOT(getPropertiesAsyncResp(QVariantMap)),
 					SLOT(getPropertiesAsyncErr(const QDBusError&)),
 					GET_PROPERTIES_TIMEOUT);
@@ -125,17 +296,17 @@ void OfonoInterface::requestProperty(const QString& name)
 void OfonoInterface::getPropertiesAsyncResp(QVariantMap properties)
 {
     QString prop = m_pendingProperty;
-    m_properties = properties;
+    storeProperties(properties);
     m_pendingProperty = QString();
-    if (m_properties.keys().contains(prop)) {
-        emit requestPropertyComplete(true, prop, m_properties[prop]);
+    if (properties.contains(prop)) {
+        emit requestPropertyComplete(true, prop, properties[prop]);
     } else {
         // FIXME: should indicate that property is not available
         setError(QString(), QString("Property not available"));
         emit requestPropertyComplete(false, prop, QVariant());
     }
     foreach (QString property, properties.keys()) {
-        emit propertyChanged(property, properties[property]);
+        notifyPropertyChanged(property, properties[property]);
     }
 }
 
@@ -149,8 +320,84 @@ void OfonoInterface::getPropertiesAsyncErr(const QDBusError& error)
 
 void OfonoInterface::onPropertyChanged(QString property, QDBusVariant value)
 {
-    m_properties[property] = value.variant();
-    emit propertyChanged(property, value.variant());
+    {
+        QMutexLocker locker(&m_state->writeLock);
+        m_state->publishProperty(property, value.variant());
+    }
+    notifyPropertyChanged(property, value.variant());
+}
+
+void OfonoInterface::onPropertyUpdated(const QString& path, const QString& property, const QVariant& value)
+{
+    // the cache has already been updated on the I/O thread
+    if (path == m_path)
+        notifyPropertyChanged(property, value);
+}
+
+void OfonoInterface::notifyPropertyChanged(const QString& name, const QVariant& property)
+{
+    OfonoEventBus::instance()->publishProperty(m_path, m_ifname, name, property);
+    emit propertyChanged(name, property);
+
+    // receivers may add or remove triggers, so don't emit while iterating
+    QList<int> fired;
+    for (QMap<int, OfonoPropertyTrigger>::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i) {
+        if (i.value().name() == name && i.value().update(property))
+            fired << i.key();
+    }
+    foreach (int id, fired)
+        emit propertyTriggered(id, name, property);
+
+    if (m_callbacks.isEmpty())
+        return;
+    // a copy, so that callbacks can unregister themselves; one removed by
+    // an earlier callback is not invoked
+    QList<QPair<int, OfonoPropertyCallback> > callbacks = m_callbacks.value(name);
+    for (int i = 0; i < callbacks.count(); i++) {
+        if (m_callbackNames.contains(callbacks[i].first))
+            callbacks[i].second(property);
+    }
+}
+
+int OfonoInterface::addPropertyTrigger(const OfonoPropertyTrigger& trigger)
+{
+    OfonoPropertyTrigger t = trigger;
+    t.reset();
+    QVariantMap cached = properties();
+    if (cached.contains(t.name()))
+        t.update(cached[t.name()]);
+    m_triggers.insert(++m_lastTriggerId, t);
+    return m_lastTriggerId;
+}
+
+void OfonoInterface::removePropertyTrigger(int id)
+{
+    m_triggers.remove(id);
+}
+
+int OfonoInterface::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    if (!callback)
+        return 0;
+    m_callbacks[name].append(qMakePair(++m_lastCallbackHandle, callback));
+    m_callbackNames.insert(m_lastCallbackHandle, name);
+    return m_lastCallbackHandle;
+}
+
+void OfonoInterface::removePropertyCallback(int handle)
+{
+    if (!m_callbackNames.contains(handle))
+        return;
+    QString name = m_callbackNames.take(handle);
+    QList<QPair<int, OfonoPropertyCallback> > &callbacks = m_callbacks[name];
+    for (int i = 0; i < callbacks.count(); i++) {
+        if (callbacks[i].first == handle) {
+            callbacks.removeAt(i);
+            break;
+        }
+    }
+    if (callbacks.isEmpty())
+        m_callbacks.remove(name);
 }
 
 void OfonoInterface::setProperty(const QString& name, const QVariant& property, const QString& password)
@@ -163,7 +410,7 @@ void OfonoInterface::setProperty(const QString& name, const QVariant& property,
     }
 
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_connection.service(),
 					     m_path, m_ifname,
 					     "SetProperty");
 
@@ -173,7 +420,7 @@ void OfonoInterface::setProperty(const QString& name, const QVariant& property,
         arguments << QVariant(password);
 
     request.setArguments(arguments);
-    bool result = QDBusConnection::systemBus().callWithCallback(request, this,
+    bool result = m_connection.bus().callWithCallback(request, this,
     					SLOT(setPropertyResp()),
     					SLOT(setPropertyErr(const QDBusError&)),
     					SET_PROPERTY_TIMEOUT);
@@ -26,11 +26,23 @@
 
 #include <QtCore/QObject>
 #include <QVariant>
+#include <QHash>
+#include <QPair>
+#include <QSharedPointer>
 #include <QDBusVariant>
 #include <QDBusError>
 #include "ofonopropertysetting.h"
+#include "ofonopropertytrigger.h"
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
+#include "ofonoconnection.h"
 #include "libofono-qt_global.h"
 
+struct OfonoInterfaceState;
+class OfonoInterfaceReceiver;
+class OfonoServiceTracker;
+class QDBusPendingCallWatcher;
+
 //! Basic oFono interface class
 /*!
  * This class implements basic access to properties of oFono interfaces.
@@ -55,8 +67,24 @@ public:
      * Returns the full set of current properties. If the object was constructed with
      * OfonoInterface::GetAllOnFirstRequest, and no properties have been explicitly queried yet
      * via requestProperty(), then returns nothing.
+     *
+     * This method is thread-safe. If the object was created with the I/O thread
+     * enabled, see OfonoIoThread, it returns the latest values even while the
+     * thread of the object is busy.
      */
     QVariantMap properties() const;
+
+    //! Get an immutable snapshot of all properties
+    /*!
+     * Unlike separate reads of individual properties, all values in a snapshot
+     * come from the same update.
+     *
+     * This method is thread-safe. It does not wait for the thread of the
+     * object, but the snapshot is loaded with the atomic std::shared_ptr
+     * operations, which the standard library may implement with a short
+     * internal lock.
+     */
+    OfonoPropertySnapshot snapshot() const;
     
     //! Request a property asynchronously.
     /*! 
@@ -70,9 +98,44 @@ public:
      * if setting is successful or via setPropertyFailed() signal if setting has failed.
      */
     void setProperty(const QString &name, const QVariant &property, const QString& password=0);
+
+    //! Adds a property trigger
+    /*!
+     * The trigger is evaluated on every update of its property, and
+     * propertyTriggered() is issued only when the update completes the
+     * transition described by the trigger. If the property value is already
+     * known, it is used as the starting state.
+     *
+     * Returns an id that identifies the trigger in propertyTriggered() and
+     * removePropertyTrigger().
+     */
+    int addPropertyTrigger(const OfonoPropertyTrigger &trigger);
+
+    //! Removes a property trigger added with addPropertyTrigger()
+    void removePropertyTrigger(int id);
+
+    //! Registers a callback for changes of a property
+    /*!
+     * The callback is invoked directly whenever propertyChanged() is issued
+     * for the property, without a signal-slot lookup.
+     *
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
     
     //! Resets the property cache.
     void resetProperties();
+
+    //! Returns true if the properties were loaded from a saved cache and are not confirmed yet
+    /*!
+     * See OfonoPropertyCache::load(). Once the properties have been
+     * reconciled with oFono, propertyChanged() is issued for every value
+     * that has changed.
+     */
+    bool isStale() const {return m_stale;}
     
     //! Get the interface D-Bus path
     QString path() const {return m_path;}
@@ -80,6 +143,9 @@ public:
     //! Get the interface D-Bus name
     QString ifname() const {return m_ifname;}
 
+    //! Get the D-Bus connection and service name, see OfonoConnection
+    const OfonoConnection &connection() const {return m_connection;}
+
     //! Get the D-Bus error name of the last operation.
     /*!
      * Returns the D-Bus error name of the last operation (setting a property
@@ -102,6 +168,15 @@ public Q_SLOTS:
      * GetAllOnStartup or reset otherwise.
      */
     void setPath(const QString &path);
+
+    //! Changes the interface path without blocking
+    /*!
+     * Like setPath(), but with GetAllOnStartup the properties are taken from
+     * the cache if they are there, or requested asynchronously otherwise.
+     * propertiesReady() is issued once they are available, or with false
+     * if requesting them has failed.
+     */
+    void setPathAsync(const QString &path);
     
     //! Sets the last error explicitly
     void setError(const QString &errorName, const QString &errorMessage);
@@ -128,8 +203,24 @@ Q_SIGNALS:
      */
     void setPropertyFailed(const QString &name);
 
+    //! Issued when a property update has matched a trigger
+    /*!
+     * \param id trigger id returned by addPropertyTrigger()
+     * \param name name of the property
+     * \param property value of the property
+     */
+    void propertyTriggered(int id, const QString &name, const QVariant &property);
+
+    //! Issued when the properties have been fetched after setPathAsync() or a restart of oFono
+    void propertiesReady(const QString &path, bool success);
+
 private Q_SLOTS:
     void onPropertyChanged(QString property, QDBusVariant value);
+    void onPropertyUpdated(const QString &path, const QString &property, const QVariant &value);
+    void onServiceLost();
+    void onServiceReturned();
+    void resyncPropertiesFinished(QDBusPendingCallWatcher *watcher);
+    void onReconciled(const QString &path, const QString &ifname, const QVariantMap &changed);
     void getPropertiesAsyncResp(QVariantMap properties);
     void getPropertiesAsyncErr(const QDBusError&);
     void setPropertyResp();
@@ -137,17 +228,36 @@ private Q_SLOTS:
 protected Q_SLOTS:
 private:
     QVariantMap getAllPropertiesSync();
+    bool fetchCachedProperties(QVariantMap &properties, bool wait);
+    void fetchPropertiesAsync();
+    void switchPath(const QString &path);
+    void storeProperties(const QVariantMap &properties);
+    void connectPropertyChanged();
+    void disconnectPropertyChanged();
+    void cancelResync();
+    void clearStale();
+    void notifyPropertyChanged(const QString &name, const QVariant &property);
     
 protected:
    QString m_errorName;
    QString m_errorMessage;
     
 private:
+   OfonoConnection m_connection;
    QString m_path;
    QString m_ifname;
-   QVariantMap m_properties;
    QString m_pendingProperty;
    OfonoGetPropertySetting m_getpropsetting;
+   QMap<int, OfonoPropertyTrigger> m_triggers;
+   int m_lastTriggerId;
+   QHash<QString, QList<QPair<int, OfonoPropertyCallback> > > m_callbacks;
+   QHash<int, QString> m_callbackNames;
+   int m_lastCallbackHandle;
+   QSharedPointer<OfonoInterfaceState> m_state;
+   OfonoInterfaceReceiver *m_receiver;
+   OfonoServiceTracker *m_tracker;
+   QDBusPendingCallWatcher *m_resyncWatcher;
+   bool m_stale;
 };
 
 #endif
@@ -0,0 +1,123 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOINTERFACE_P_H
+#define OFONOINTERFACE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the ofono-qt API. It may change from version
+// to version without notice, or even be removed.
+//
+
+#include <memory>
+#include <QtCore/QObject>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QDBusContext>
+#include <QDBusVariant>
+
+struct OfonoPropertySnapshotData
+{
+    quint64 version;
+    QString path;
+    QVariantMap properties;
+};
+
+//! Property cache of an OfonoInterface, shared with its I/O thread receiver
+/*!
+ * The cache is a chain of immutable snapshots. Readers load the current one
+ * atomically and never take writeLock; writers, which may be the owning
+ * thread and the I/O thread, serialize on writeLock and publish a modified
+ * copy.
+ */
+struct OfonoInterfaceState
+{
+    explicit OfonoInterfaceState(const QString &path)
+    {
+        std::shared_ptr<OfonoPropertySnapshotData> data = std::make_shared<OfonoPropertySnapshotData>();
+        data->version = 0;
+        data->path = path;
+        current = data;
+    }
+
+    std::shared_ptr<const OfonoPropertySnapshotData> load() const
+    {
+        return std::atomic_load(&current);
+    }
+
+    // must be called with writeLock held
+    void publish(const QString &path, const QVariantMap &properties)
+    {
+        std::shared_ptr<OfonoPropertySnapshotData> data = std::make_shared<OfonoPropertySnapshotData>();
+        data->version = load()->version + 1;
+        data->path = path;
+        data->properties = properties;
+        std::atomic_store(&current, std::shared_ptr<const OfonoPropertySnapshotData>(data));
+    }
+
+    // must be called with writeLock held
+    void publishProperty(const QString &name, const QVariant &value)
+    {
+        std::shared_ptr<const OfonoPropertySnapshotData> last = load();
+        QVariantMap properties = last->properties;
+        properties.insert(name, value);
+        publish(last->path, properties);
+    }
+
+    QMutex writeLock;
+    std::shared_ptr<const OfonoPropertySnapshotData> current;
+};
+
+//! Updates the property cache of an OfonoInterface on the I/O thread
+class OfonoInterfaceReceiver : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+public:
+    explicit OfonoInterfaceReceiver(const QSharedPointer<OfonoInterfaceState> &state)
+        : QObject(0), m_state(state) {}
+
+Q_SIGNALS:
+    void propertyUpdated(const QString &path, const QString &name, const QVariant &value);
+
+public Q_SLOTS:
+    void onPropertyChanged(QString property, QDBusVariant value)
+    {
+        // a signal from the previous path may still arrive after setPath()
+        QString path = message().path();
+        {
+            QMutexLocker locker(&m_state->writeLock);
+            if (path != m_state->load()->path)
+                return;
+            m_state->publishProperty(property, value.variant());
+        }
+        emit propertyUpdated(path, property, value.variant());
+    }
+
+private:
+    QSharedPointer<OfonoInterfaceState> m_state;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtCore/QCoreApplication>
+#include <QThread>
+
+#include "ofonoiothread.h"
+
+static bool ioThreadEnabled = false;
+static QThread *ioThread = 0;
+
+static void stopIoThread()
+{
+    if (!ioThread)
+        return;
+    ioThread->quit();
+    ioThread->wait();
+    delete ioThread;
+    ioThread = 0;
+}
+
+void OfonoIoThread::setEnabled(bool enabled)
+{
+    ioThreadEnabled = enabled;
+    if (enabled && !ioThread) {
+        ioThread = new QThread();
+        ioThread->setObjectName("ofono-qt I/O");
+        ioThread->start();
+        qAddPostRoutine(stopIoThread);
+    }
+}
+
+bool OfonoIoThread::isEnabled()
+{
+    return ioThreadEnabled;
+}
+
+QThread *OfonoIoThread::thread()
+{
+    return ioThread;
+}
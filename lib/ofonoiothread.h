@@ -0,0 +1,59 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOIOTHREAD_H
+#define OFONOIOTHREAD_H
+
+#include "libofono-qt_global.h"
+
+class QThread;
+
+//! Controls the internal D-Bus I/O thread
+/*!
+ * By default, everything the library does happens in the thread in which
+ * its objects live, so a slow slot in that thread delays the processing of
+ * PropertyChanged signals for every modem.
+ *
+ * When the I/O thread is enabled, the library objects created afterwards
+ * receive oFono PropertyChanged signals and update their property caches
+ * on the I/O thread. Their property getters, such as OfonoModem::online() or
+ * OfonoNetworkRegistration::strength(), then always return the latest
+ * value and may be called from any thread. The change signals, triggers and
+ * callbacks are still issued in the thread in which the object lives, once
+ * its event loop gets to them.
+ *
+ * Everything else, including D-Bus paths, validity, method calls, property
+ * requests and setters, remains bound to the thread in which the object lives.
+ */
+class OFONO_QT_EXPORT OfonoIoThread
+{
+public:
+    //! Enables or disables the I/O thread for objects created from now on
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    //! Returns the I/O thread, or 0 if it has never been enabled
+    static QThread *thread();
+};
+
+#endif
@@ -29,24 +29,44 @@
 
 
 OfonoMessage::OfonoMessage(const QString& messageId, QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_if(0)
 {
-    m_if = new OfonoInterface(messageId, "org.ofono.Message", OfonoGetAllOnStartup, this);
-
-    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
-            this, SLOT(propertyChanged(const QString&, const QVariant&)));
+    // the last copy may go away from a slot connected to the shared state
+    attach(QSharedPointer<OfonoInterface>(new OfonoInterface(messageId, "org.ofono.Message", OfonoGetAllOnStartup),
+                                          &QObject::deleteLater));
 }
 
 OfonoMessage::OfonoMessage(const OfonoMessage& message)
-    : QObject(message.parent())
+    : QObject(message.parent()), m_if(0)
 {
-    m_if = new OfonoInterface(message.path(), "org.ofono.Message", OfonoGetAllOnStartup, this);
+    attach(message.m_shared);
+}
 
-    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
-            this, SLOT(propertyChanged(const QString&, const QVariant&)));
+OfonoMessage::OfonoMessage(OfonoMessage &&message)
+    : QObject(message.parent()), m_if(0)
+{
+    attach(message.detach());
 }
 
-bool OfonoMessage::operator==(const OfonoMessage &message)
+OfonoMessage &OfonoMessage::operator=(const OfonoMessage &message)
+{
+    if (m_shared != message.m_shared) {
+        detach();
+        attach(message.m_shared);
+    }
+    return *this;
+}
+
+OfonoMessage &OfonoMessage::operator=(OfonoMessage &&message)
+{
+    if (this != &message) {
+        detach();
+        attach(message.detach());
+    }
+    return *this;
+}
+
+bool OfonoMessage::operator==(const OfonoMessage &message) const
 {
     return path() == message.path();
 }
@@ -55,6 +75,27 @@ OfonoMessage::~OfonoMessage()
 {
 }
 
+void OfonoMessage::attach(const QSharedPointer<OfonoInterface> &shared)
+{
+    m_shared = shared;
+    if (!m_shared)
+        return;
+    m_if = m_shared.data();
+
+    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
+            this, SLOT(propertyChanged(const QString&, const QVariant&)));
+}
+
+QSharedPointer<OfonoInterface> OfonoMessage::detach()
+{
+    QSharedPointer<OfonoInterface> shared;
+    if (m_shared)
+        disconnect(m_if, 0, this, 0);
+    shared.swap(m_shared);
+    m_if = 0;
+    return shared;
+}
+
 QString OfonoMessage::state() const
 {
     return m_if->properties()["State"].value<QString>();
@@ -81,3 +122,18 @@ QString OfonoMessage::errorMessage() const
 {
     return m_if->errorMessage();
 }
+
+int OfonoMessage::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    return m_if->addPropertyCallback(name, callback);
+}
+
+void OfonoMessage::removePropertyCallback(int handle)
+{
+    m_if->removePropertyCallback(handle);
+}
+
+OfonoPropertySnapshot OfonoMessage::snapshot() const
+{
+    return m_if->snapshot();
+}
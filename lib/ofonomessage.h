@@ -27,7 +27,10 @@
 #include <QVariant>
 #include <QStringList>
 #include <QDBusError>
+#include <QSharedPointer>
 
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
 #include "libofono-qt_global.h"
 
 class OfonoInterface;
@@ -36,6 +39,10 @@ class OfonoInterface;
 /*!
  * oFono message API is documented in
  * http://git.kernel.org/?p=network/ofono/ofono.git;a=blob_plain;f=doc/message-api.txt
+ *
+ * Copies are cheap: they share the property cache and the D-Bus
+ * subscriptions of the original, so copying does not talk to oFono. A
+ * moved-from object may only be assigned to or destroyed.
  */
 class OFONO_QT_EXPORT OfonoMessage : public QObject
 {
@@ -50,10 +57,15 @@ class OFONO_QT_EXPORT OfonoMessage : public QObject
 public:
     OfonoMessage(const QString &messageId, QObject *parent=0);
     OfonoMessage(const OfonoMessage &message);
+    OfonoMessage(OfonoMessage &&message);
     ~OfonoMessage();
 
-    OfonoMessage operator=(const OfonoMessage &message);
-    bool operator==(const OfonoMessage &message);
+    OfonoMessage &operator=(const OfonoMessage &message);
+    OfonoMessage &operator=(OfonoMessage &&message);
+    bool operator==(const OfonoMessage &message) const;
+
+    //! Returns true if both objects share the same backing state
+    bool isSharedWith(const OfonoMessage &message) const {return m_shared == message.m_shared;}
 
     //! Returns the D-Bus object path of the message object
     QString path() const;
@@ -74,6 +86,21 @@ public:
 
     QString state() const;
 
+    //! Registers a callback for changes of a message property
+    /*!
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
+
+    //! Returns an immutable snapshot of all message properties
+    /*!
+     * See OfonoInterface::snapshot().
+     */
+    OfonoPropertySnapshot snapshot() const;
+
 Q_SIGNALS:
     void stateChanged(const QString &state);
 
@@ -81,6 +108,11 @@ private Q_SLOTS:
     void propertyChanged(const QString &property, const QVariant &value);
 
 private:
+    void attach(const QSharedPointer<OfonoInterface> &shared);
+    QSharedPointer<OfonoInterface> detach();
+
+private:
+    QSharedPointer<OfonoInterface> m_shared;
     OfonoInterface *m_if;
 
 };
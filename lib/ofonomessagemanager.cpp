@@ -26,6 +26,26 @@
 
 #include "ofonomessagemanager.h"
 #include "ofonointerface.h"
+#include "ofonoeventbus.h"
+#include "ofonoservicetracker.h"
+
+// the message manager that publishes the incoming messages of a modem on
+// the event bus, so that a message is published once however many
+// managers receive it
+static QHash<QString, OfonoMessageManager*> incomingPublishers;
+
+// hands the modems published by a manager over to the next manager that
+// receives a message from them
+static void releaseIncomingPublisher(OfonoMessageManager *manager)
+{
+    QHash<QString, OfonoMessageManager*>::iterator i = incomingPublishers.begin();
+    while (i != incomingPublishers.end()) {
+        if (i.value() == manager)
+            i = incomingPublishers.erase(i);
+        else
+            ++i;
+    }
+}
 
 QDBusArgument &operator<<(QDBusArgument &argument, const OfonoMessageManagerStruct &message)
 {
@@ -45,11 +65,23 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, OfonoMessageManag
 
 OfonoMessageManager::OfonoMessageManager(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.MessageManager", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+OfonoMessageManager::OfonoMessageManager(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.MessageManager", OfonoGetAllOnFirstRequest, parent)
+{
+    init();
+}
+
+void OfonoMessageManager::init()
 {
     qDBusRegisterMetaType<OfonoMessageManagerStruct>();
     qDBusRegisterMetaType<OfonoMessageManagerList>();
 
-    m_messagelist = getMessageList();
+    m_refreshWatcher = 0;
+    m_messagelist = OfonoPathSet(getMessageList());
 
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -62,19 +94,54 @@ OfonoMessageManager::OfonoMessageManager(OfonoModem::SelectionSetting modemSetti
     connect(modem(), SIGNAL(pathChanged(QString)), this, SLOT(pathChanged(const QString&)));
 
     connectDbusSignals(path());
+
+    OfonoServiceTracker *tracker = OfonoServiceTracker::forConnection(m_if->connection());
+    connect(tracker, SIGNAL(serviceLost()), this, SLOT(onServiceLost()));
+    connect(tracker, SIGNAL(serviceReturned()), this, SLOT(onServiceReturned()));
 }
 
 OfonoMessageManager::~OfonoMessageManager()
 {
+    releaseIncomingPublisher(this);
 }
 
-void OfonoMessageManager::validityChanged(bool /*validity*/)
+void OfonoMessageManager::validityChanged(bool validity)
 {
-    m_messagelist = getMessageList();
+    // the messages of another modem are fetched without blocking; until the
+    // reply arrives the list is left as it is
+    delete m_refreshWatcher;
+    m_refreshWatcher = 0;
+    if (!validity) {
+        m_messagelist = OfonoPathSet();
+        return;
+    }
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                          path(), m_if->ifname(),
+                                                          "GetMessages");
+    m_refreshWatcher = new QDBusPendingCallWatcher(m_if->connection().bus().asyncCall(request), this);
+    connect(m_refreshWatcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(refreshMessagesFinished(QDBusPendingCallWatcher*)));
+}
+
+void OfonoMessageManager::refreshMessagesFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<OfonoMessageManagerList> reply = *watcher;
+    watcher->deleteLater();
+    m_refreshWatcher = 0;
+
+    QStringList messageList;
+    if (!reply.isError()) {
+        foreach (OfonoMessageManagerStruct message, reply.value())
+            messageList << message.path.path();
+    }
+    m_messagelist = OfonoPathSet(messageList);
 }
 
 void OfonoMessageManager::pathChanged(const QString& path)
 {
+    // the messages of the old modem now reach other managers only
+    releaseIncomingPublisher(this);
     connectDbusSignals(path);
 }
 
@@ -85,10 +152,10 @@ QStringList OfonoMessageManager::getMessageList()
     QDBusMessage request;
     QStringList messageList;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "GetMessages");
-    reply = QDBusConnection::systemBus().call(request);
+    reply = m_if->connection().bus().call(request);
 
     messages = reply;
     foreach(OfonoMessageManagerStruct message, messages) {
@@ -99,44 +166,44 @@ QStringList OfonoMessageManager::getMessageList()
 
 void OfonoMessageManager::connectDbusSignals(const QString& path)
 {
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "MessageAdded",
                                          this,
                                          SLOT(onMessageAdded(const QDBusObjectPath&, const QVariantMap&)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "MessageRemoved",
                                          this,
                                          SLOT(onMessageRemoved(const QDBusObjectPath&)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "IncomingMessage",
                                          this,
-                                         SIGNAL(incomingMessage(QString, QVariantMap)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+                                         SLOT(onIncomingMessage(const QString&, const QVariantMap&)));
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "ImmediateMessage",
                                          this,
                                          SIGNAL(immediateMessage(QString, QVariantMap)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "StatusReport",
                                          this,
                                          SIGNAL(statusReport(QString, QVariantMap)));
 
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "MessageAdded",
                                          this,
                                          SLOT(onMessageAdded(const QDBusObjectPath&, const QVariantMap&)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "MessageRemoved",
                                          this,
                                          SLOT(onMessageRemoved(const QDBusObjectPath&)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "IncomingMessage",
                                          this,
-                                         SIGNAL(incomingMessage(QString, QVariantMap)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+                                         SLOT(onIncomingMessage(const QString&, const QVariantMap&)));
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "ImmediateMessage",
                                          this,
                                          SIGNAL(immediateMessage(QString, QVariantMap)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "StatusReport",
                                          this,
                                          SIGNAL(statusReport(QString, QVariantMap)));
@@ -188,11 +255,11 @@ QDBusObjectPath OfonoMessageManager::sendMessage(const QString &to, const QStrin
     QDBusMessage request;
     QDBusReply<QDBusObjectPath> reply;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "SendMessage");
     request << to << message;
-    reply = QDBusConnection::systemBus().call(request);
+    reply = m_if->connection().bus().call(request);
     success = reply.isValid();
     if (!success) {
         m_if->setError(reply.error().name(), reply.error().message());
@@ -241,17 +308,63 @@ void OfonoMessageManager::setPropertyFailed(const QString& property)
 
 QStringList OfonoMessageManager::getMessages() const
 {
-    return m_messagelist;
+    return m_messagelist.toList();
 }
 
-void OfonoMessageManager::onMessageAdded(const QDBusObjectPath &path, const QVariantMap& /*properties*/)
+void OfonoMessageManager::onMessageAdded(const QDBusObjectPath &path, const QVariantMap& properties)
 {
-    m_messagelist << path.path();
+    m_messagelist.insert(path.path());
+    OfonoEventBus::instance()->publish(OfonoEvent::MessageAdded, path.path(), "org.ofono.Message", properties);
     emit messageAdded(path.path());
 }
 
 void OfonoMessageManager::onMessageRemoved(const QDBusObjectPath &path)
 {
-    m_messagelist.removeAll(path.path());
+    m_messagelist.remove(path.path());
+    OfonoEventBus::instance()->publish(OfonoEvent::MessageRemoved, path.path(), "org.ofono.Message");
     emit messageRemoved(path.path());
 }
+
+void OfonoMessageManager::onIncomingMessage(const QString &message, const QVariantMap &info)
+{
+    OfonoMessageManager *&publisher = incomingPublishers[m_if->path()];
+    if (!publisher)
+        publisher = this;
+    if (publisher == this)
+        OfonoEventBus::instance()->publish(OfonoEvent::MessageIncoming, m_if->path(), m_if->ifname(),
+                                           QVariantList() << message << info);
+    emit incomingMessage(message, info);
+}
+
+void OfonoMessageManager::onServiceLost()
+{
+    foreach (QString message, m_messagelist.toList())
+        onMessageRemoved(QDBusObjectPath(message));
+}
+
+void OfonoMessageManager::onServiceReturned()
+{
+    if (path() == "/")
+        return;
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                          path(), m_if->ifname(),
+                                                          "GetMessages");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_if->connection().bus().asyncCall(request), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(resyncMessagesFinished(QDBusPendingCallWatcher*)));
+    OfonoServiceTracker::forConnection(m_if->connection())->addFetch(watcher);
+}
+
+void OfonoMessageManager::resyncMessagesFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<OfonoMessageManagerList> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError())
+        return;
+    foreach (OfonoMessageManagerStruct message, reply.value()) {
+        if (!m_messagelist.contains(message.path.path()))
+            onMessageAdded(message.path, message.properties);
+    }
+}
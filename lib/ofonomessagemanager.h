@@ -28,8 +28,11 @@
 #include <QDBusError>
 #include <QDBusObjectPath>
 #include "ofonomodeminterface.h"
+#include "ofonopathset.h"
 #include "libofono-qt_global.h"
 
+class QDBusPendingCallWatcher;
+
 struct OfonoMessageManagerStruct {
     QDBusObjectPath path;
     QVariantMap properties;
@@ -50,9 +53,14 @@ class OFONO_QT_EXPORT OfonoMessageManager : public OfonoModemInterface
 
 public:
     OfonoMessageManager(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoMessageManager(OfonoModem *modem, QObject *parent=0);
     ~OfonoMessageManager();
 
     Q_INVOKABLE QStringList getMessages() const;
+
+    //! Returns the messages as a set, for constant-time lookups
+    const OfonoPathSet &messagePaths() const {return m_messagelist;}
 public Q_SLOTS:
     /* Properties */
     void requestServiceCenterAddress();
@@ -96,13 +104,20 @@ private Q_SLOTS:
     void requestPropertyComplete(bool success, const QString &property, const QVariant &value);
     void onMessageAdded(const QDBusObjectPath &message, const QVariantMap &properties);
     void onMessageRemoved(const QDBusObjectPath &message);
+    void onServiceLost();
+    void onServiceReturned();
+    void resyncMessagesFinished(QDBusPendingCallWatcher *watcher);
+    void refreshMessagesFinished(QDBusPendingCallWatcher *watcher);
+    void onIncomingMessage(const QString &message, const QVariantMap &info);
 
 private:
     QStringList getMessageList();
     void connectDbusSignals(const QString& path);
 
 private:
-    QStringList m_messagelist;
+    void init();
+    OfonoPathSet m_messagelist;
+    QDBusPendingCallWatcher *m_refreshWatcher;
 };
 
 #endif  /* !OFONOMESSAGEMANAGER_H */
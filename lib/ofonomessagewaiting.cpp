@@ -30,12 +30,22 @@
 
 OfonoMessageWaiting::OfonoMessageWaiting(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.MessageWaiting", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoMessageWaiting::OfonoMessageWaiting(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.MessageWaiting", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoMessageWaiting::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
     connect(m_if, SIGNAL(setPropertyFailed(const QString&)), 
             this, SLOT(setPropertyFailed(const QString&)));
-
 }
 
 OfonoMessageWaiting::~OfonoMessageWaiting()
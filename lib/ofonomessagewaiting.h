@@ -43,6 +43,8 @@ class OFONO_QT_EXPORT OfonoMessageWaiting : public OfonoModemInterface
 
 public:
     OfonoMessageWaiting(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoMessageWaiting(OfonoModem *modem, QObject *parent=0);
     ~OfonoMessageWaiting();
 
     bool voicemailWaiting() const;
@@ -61,6 +63,9 @@ Q_SIGNALS:
 private Q_SLOTS:
     void propertyChanged(const QString& property, const QVariant& value);
     void setPropertyFailed(const QString& property);    
+
+private:
+    void init();
 };
 
 #endif  /* !OFONOMESSAGEWAITING_H */
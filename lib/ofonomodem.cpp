@@ -23,24 +23,159 @@
 
 #include <QtDBus/QtDBus>
 #include <QtCore/QObject>
+#include <QtCore/QMutex>
+#include <QtCore/QAtomicPointer>
 
 #include "ofonomodem.h"
 #include "ofonointerface.h"
 #include "ofonomodemmanager.h"
+#include "ofonopropertycache.h"
+#include "ofonoservicetracker.h"
+
+// the names that have a bit; never modified once published
+struct OfonoBitNames {
+    QHash<QString, int> bits;
+    QStringList names;
+};
+
+struct OfonoBitRegistry {
+    QMutex lock;    // serializes registrations
+    QAtomicPointer<const OfonoBitNames> names;
+};
+
+static OfonoBitRegistry *newRegistry(const QStringList &names)
+{
+    OfonoBitNames *initial = new OfonoBitNames;
+    initial->names = names;
+    for (int i = 0; i < names.count(); i++)
+        initial->bits.insert(names[i], i);
+    OfonoBitRegistry *registry = new OfonoBitRegistry;
+    registry->names.storeRelease(initial);
+    return registry;
+}
+
+static OfonoBitRegistry *interfaceRegistry()
+{
+    // the interfaces known at the time of writing get stable bits
+    static OfonoBitRegistry *registry = newRegistry(QStringList()
+        << "org.ofono.AssistedSatelliteNavigation" << "org.ofono.AudioSettings"
+        << "org.ofono.CallBarring" << "org.ofono.CallForwarding"
+        << "org.ofono.CallMeter" << "org.ofono.CallSettings"
+        << "org.ofono.CallVolume" << "org.ofono.CellBroadcast"
+        << "org.ofono.ConnectionManager" << "org.ofono.Handsfree"
+        << "org.ofono.LocationReporting" << "org.ofono.MessageManager"
+        << "org.ofono.MessageWaiting" << "org.ofono.NetworkRegistration"
+        << "org.ofono.NetworkTime" << "org.ofono.Phonebook"
+        << "org.ofono.PushNotification" << "org.ofono.RadioSettings"
+        << "org.ofono.SimManager" << "org.ofono.SimToolkit"
+        << "org.ofono.SmartMessaging" << "org.ofono.SupplementaryServices"
+        << "org.ofono.TextTelephony" << "org.ofono.VoiceCallManager");
+    return registry;
+}
+
+static OfonoBitRegistry *featureRegistry()
+{
+    static OfonoBitRegistry *registry = newRegistry(QStringList()
+        << "net" << "rat" << "cbs" << "sms" << "sim"
+        << "stk" << "ussd" << "gprs" << "tty" << "gps");
+    return registry;
+}
+
+static int lookupBit(OfonoBitRegistry *registry, const QString &name)
+{
+    return registry->names.loadAcquire()->bits.value(name, -1);
+}
+
+static int registerBit(OfonoBitRegistry *registry, const QString &name)
+{
+    QMutexLocker locker(&registry->lock);
+    const OfonoBitNames *current = registry->names.loadAcquire();
+    QHash<QString, int>::const_iterator i = current->bits.find(name);
+    if (i != current->bits.end())
+        return i.value();
+    if (current->names.count() >= 64)
+        return -1;
+
+    // lookups may still be reading the current names, so they are replaced
+    // rather than modified; at most 64 of them are ever left behind
+    OfonoBitNames *next = new OfonoBitNames(*current);
+    next->names << name;
+    next->bits.insert(name, next->names.count() - 1);
+    registry->names.storeRelease(next);
+    return next->names.count() - 1;
+}
+
+static quint64 decodeBits(OfonoBitRegistry *registry, const QStringList &names, QStringList *extra)
+{
+    quint64 bits = 0;
+    foreach (QString name, names) {
+        int bit = registerBit(registry, name);
+        if (bit >= 0)
+            bits |= Q_UINT64_C(1) << bit;
+        else if (extra)
+            *extra << name;
+    }
+    return bits;
+}
+
+// number of modem objects that have selected a modem, by connection and path;
+// modem objects may live in different threads
+static QMutex selectionsLock;
+static QHash<QString, int> selections;
+
+static QString selectionKey(const OfonoConnection &connection, const QString &modemPath)
+{
+    return connection.bus().name() + '\n' + connection.service() + '\n' + modemPath;
+}
+
+static void countSelection(const OfonoConnection &connection, const QString &modemPath, int delta)
+{
+    if (modemPath == "/")
+        return;
+    QString key = selectionKey(connection, modemPath);
+    QMutexLocker locker(&selectionsLock);
+    int count = selections.value(key) + delta;
+    if (count > 0)
+        selections.insert(key, count);
+    else
+        selections.remove(key);
+}
+
+static QVariant cachedProperty(OfonoPropertyCache *cache, const QString &modemPath, const QString &ifname, const QString &name)
+{
+    // entries that are still being fetched do not count yet
+    QVariantMap properties;
+    if (!cache->contains(modemPath, ifname) || !cache->fetch(modemPath, ifname, properties))
+        return QVariant();
+    return properties.value(name);
+}
 
 OfonoModem::OfonoModem(SelectionSetting setting, const QString &modemPath, QObject *parent)
-	: QObject(parent), m_selectionSetting(setting)
+	: QObject(parent), m_if(0), m_selectionSetting(setting), m_policy(FirstAvailablePolicy),
+	  m_failoverPending(false), m_failoverLatency(-1), m_interfaceBits(0), m_featureBits(0)
+{
+    init(modemPath);
+}
+
+OfonoModem::OfonoModem(SelectionPolicy policy, QObject *parent)
+	: QObject(parent), m_if(0), m_selectionSetting(AutomaticSelect), m_policy(policy),
+	  m_failoverPending(false), m_failoverLatency(-1), m_interfaceBits(0), m_featureBits(0)
+{
+    init(QString());
+}
+
+void OfonoModem::init(const QString &modemPath)
 {
-    
     m_mm = new OfonoModemManager(this);
     connect(m_mm, SIGNAL(modemAdded(QString)), this, SLOT(modemAdded(QString)));
     connect(m_mm, SIGNAL(modemRemoved(QString)), this, SLOT(modemRemoved(QString)));
 
     QString finalModemPath;
 
-    if (setting == AutomaticSelect)
-        finalModemPath = m_mm->modems().value(0);
-    else if (setting == ManualSelect)
+    if (m_selectionSetting == AutomaticSelect) {
+        warmUpModems();
+        finalModemPath = selectModem();
+    } else if (m_selectionSetting == ManualSelect)
         finalModemPath = modemPath;
     
     if (finalModemPath.isEmpty()) {
@@ -51,11 +186,21 @@ OfonoModem::OfonoModem(SelectionSetting setting, const QString &modemPath, QObje
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
     connect(m_if, SIGNAL(setPropertyFailed(const QString&)), 
             this, SLOT(setPropertyFailed(const QString&)));
-    m_isValid = m_mm->modems().contains(finalModemPath);
+    connect(m_if, SIGNAL(propertiesReady(const QString&, bool)),
+            this, SLOT(propertiesReady(const QString&, bool)));
+    m_isValid = m_mm->modemPaths().contains(finalModemPath);
+    countSelection(m_mm->connection(), finalModemPath, 1);
+    // the initial properties were stored before the signals were connected
+    m_featureBits = decodeBits(featureRegistry(), features(), 0);
+    m_interfaceBits = decodeBits(interfaceRegistry(), interfaces(), &m_extraInterfaces);
+
+    OfonoServiceTracker *tracker = OfonoServiceTracker::forConnection(m_mm->connection());
+    connect(tracker, SIGNAL(serviceLost()), this, SLOT(onServiceLost()));
 }
 
 OfonoModem::~OfonoModem()
 {
+    countSelection(m_mm->connection(), path(), -1);
 }
 
 void OfonoModem::propertyChanged(const QString& property, const QVariant& value)
@@ -80,10 +225,75 @@ void OfonoModem::propertyChanged(const QString& property, const QVariant& value)
         emit serialChanged(value.value<QString>());
     else if (property == "Type")
         emit typeChanged(value.value<QString>());
-    else if (property == "Features")
+    else if (property == "Features") {
+        m_featureBits = decodeBits(featureRegistry(), value.value<QStringList>(), 0);
         emit featuresChanged(value.value<QStringList>());
-    else if (property == "Interfaces")
+    } else if (property == "Interfaces") {
+        updateInterfaces(value.value<QStringList>());
         emit interfacesChanged(value.value<QStringList>());
+    }
+}
+
+void OfonoModem::updateInterfaces(const QStringList &interfaces)
+{
+    QStringList extra;
+    quint64 bits = decodeBits(interfaceRegistry(), interfaces, &extra);
+    quint64 changed = bits ^ m_interfaceBits;
+    QStringList extraBefore = m_extraInterfaces;
+    m_interfaceBits = bits;
+    m_extraInterfaces = extra;
+
+    if (changed || extra != extraBefore)
+        emit interfaceBitsChanged(bits, changed);
+    for (int bit = 0; bit < 64 && (changed >> bit); bit++) {
+        quint64 mask = Q_UINT64_C(1) << bit;
+        if ((changed & mask) && !(bits & mask))
+            emit interfaceDisappeared(interfaceName(bit));
+    }
+    foreach (QString ifname, extraBefore) {
+        if (!extra.contains(ifname))
+            emit interfaceDisappeared(ifname);
+    }
+    for (int bit = 0; bit < 64 && (changed >> bit); bit++) {
+        quint64 mask = Q_UINT64_C(1) << bit;
+        if (changed & bits & mask)
+            emit interfaceAppeared(interfaceName(bit));
+    }
+    foreach (QString ifname, extra) {
+        if (!extraBefore.contains(ifname))
+            emit interfaceAppeared(ifname);
+    }
+}
+
+bool OfonoModem::hasInterface(const QString &ifname) const
+{
+    int bit = interfaceBit(ifname);
+    if (bit < 0)
+        return m_extraInterfaces.contains(ifname);
+    return m_interfaceBits & (Q_UINT64_C(1) << bit);
+}
+
+bool OfonoModem::hasFeature(const QString &feature) const
+{
+    int bit = featureBit(feature);
+    if (bit < 0)
+        return features().contains(feature);
+    return m_featureBits & (Q_UINT64_C(1) << bit);
+}
+
+int OfonoModem::interfaceBit(const QString &ifname)
+{
+    return lookupBit(interfaceRegistry(), ifname);
+}
+
+QString OfonoModem::interfaceName(int bit)
+{
+    return interfaceRegistry()->names.loadAcquire()->names.value(bit);
+}
+
+int OfonoModem::featureBit(const QString &feature)
+{
+    return lookupBit(featureRegistry(), feature);
 }
 
 void OfonoModem::setPropertyFailed(const QString& property)
@@ -96,40 +306,190 @@ void OfonoModem::setPropertyFailed(const QString& property)
         emit setLockdownFailed();
 }
 
-void OfonoModem::modemAdded(const QString& /*modem*/)
+void OfonoModem::modemAdded(const QString& modem)
 {
+    if (m_selectionSetting == AutomaticSelect
+        && (m_policy == SimPresentPolicy || m_policy == BestSignalPolicy))
+        OfonoPropertyCache::forConnection(m_mm->connection())->warmUp(modem);
     modemsChanged();
 }
 
-void OfonoModem::modemRemoved(const QString& /*modem*/)
+void OfonoModem::modemRemoved(const QString& modem)
 {
+    if (modem == path())
+        m_failoverTimer.start();
     modemsChanged();
 }
 
 void OfonoModem::modemsChanged()
 {
     // validity has changed
-    if (isValid() != m_mm->modems().contains(path())) {
-        m_isValid = m_mm->modems().contains(path());
+    if (isValid() != m_mm->modemPaths().contains(path())) {
+        m_isValid = m_mm->modemPaths().contains(path());
         emit validityChanged(isValid());
     }
-    if (!m_mm->modems().contains(path())) {
+    if (!m_mm->modemPaths().contains(path())) {
         if (m_selectionSetting == AutomaticSelect) {
-            QString modemPath = m_mm->modems().value(0);
+            QString modemPath = selectModem();
             if (modemPath.isEmpty()) {
                 modemPath = "/";
             }
-            m_if->setPath(modemPath);
-            emit pathChanged(modemPath);
+            // dropping to no modem at all is not a failover
+            if (modemPath != path())
+                switchTo(modemPath, path() != "/" && modemPath != "/");
         }
     }
     // validity has changed
-    if (isValid() != m_mm->modems().contains(path())) {
-        m_isValid = m_mm->modems().contains(path());
+    if (isValid() != m_mm->modemPaths().contains(path())) {
+        m_isValid = m_mm->modemPaths().contains(path());
+        emit validityChanged(isValid());
+    }
+}
+
+
+void OfonoModem::switchTo(const QString &modemPath, bool failover)
+{
+    m_failoverPending = failover;
+    if (failover) {
+        m_failoverFrom = path();
+        if (!m_failoverTimer.isValid())
+            m_failoverTimer.start();
+    } else {
+        // a later failover must not be timed from this removal
+        m_failoverTimer.invalidate();
+    }
+    countSelection(m_mm->connection(), path(), -1);
+    countSelection(m_mm->connection(), modemPath, 1);
+    // the interfaces of the old modem are gone; the new ones are announced
+    // as its properties arrive
+    clearBits();
+    m_if->setPathAsync(modemPath);
+    emit pathChanged(modemPath);
+}
+
+void OfonoModem::propertiesReady(const QString &modemPath, bool success)
+{
+    if (modemPath != path())
+        return;
+    // the properties may have been stored without a change notification
+    m_featureBits = decodeBits(featureRegistry(), features(), 0);
+    updateInterfaces(interfaces());
+
+    if (!m_failoverPending)
+        return;
+    m_failoverPending = false;
+    qint64 latency = m_failoverTimer.nsecsElapsed() / 1000;
+    m_failoverTimer.invalidate();
+    if (!success)
+        return;
+    m_failoverLatency = latency;
+    // after pathChanged(), which may still be on its way
+    QMetaObject::invokeMethod(this, "emitFailoverCompleted", Qt::QueuedConnection);
+}
+
+void OfonoModem::onServiceLost()
+{
+    clearBits();
+}
+
+void OfonoModem::clearBits()
+{
+    m_featureBits = 0;
+    updateInterfaces(QStringList());
+}
+
+void OfonoModem::emitFailoverCompleted()
+{
+    emit failoverCompleted(m_failoverFrom, path(), m_failoverLatency);
+}
+
+void OfonoModem::reselect()
+{
+    if (m_selectionSetting != AutomaticSelect)
+        return;
+    QString modemPath = selectModem();
+    if (modemPath.isEmpty())
+        modemPath = "/";
+    if (modemPath == path())
+        return;
+    switchTo(modemPath, false);
+    if (isValid() != m_mm->modemPaths().contains(path())) {
+        m_isValid = m_mm->modemPaths().contains(path());
         emit validityChanged(isValid());
     }
 }
 
+void OfonoModem::setSelectionPolicy(SelectionPolicy policy)
+{
+    m_policy = policy;
+    warmUpModems();
+}
+
+void OfonoModem::setSelector(const OfonoModemSelector &selector)
+{
+    m_selector = selector;
+    m_policy = CustomPolicy;
+}
+
+void OfonoModem::warmUpModems()
+{
+    if (m_policy != SimPresentPolicy && m_policy != BestSignalPolicy)
+        return;
+    OfonoPropertyCache *cache = OfonoPropertyCache::forConnection(m_mm->connection());
+    foreach (QString modem, m_mm->modems())
+        cache->warmUp(modem);
+}
+
+QString OfonoModem::selectModem() const
+{
+    QStringList modems = m_mm->modems();
+    if (m_policy == CustomPolicy) {
+        QString modemPath = m_selector ? m_selector(modems) : modems.value(0);
+        return modems.contains(modemPath) ? modemPath : QString();
+    }
+
+    // the first modem with the highest score wins
+    QString best;
+    int bestScore = 0;
+    foreach (QString modemPath, modems) {
+        int score = selectionScore(modemPath);
+        if (best.isEmpty() || score > bestScore) {
+            best = modemPath;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+int OfonoModem::selectionScore(const QString &modemPath) const
+{
+    OfonoPropertyCache *cache = OfonoPropertyCache::forConnection(m_mm->connection());
+    switch (m_policy) {
+    case FirstPoweredPolicy:
+        return cachedProperty(cache, modemPath, "org.ofono.Modem", "Powered").toBool() ? 1 : 0;
+    case SimPresentPolicy:
+        if (!cachedProperty(cache, modemPath, "org.ofono.Modem", "Powered").toBool())
+            return 0;
+        return cachedProperty(cache, modemPath, "org.ofono.SimManager", "Present").toBool() ? 2 : 1;
+    case BestSignalPolicy: {
+        QVariant strength = cachedProperty(cache, modemPath, "org.ofono.NetworkRegistration", "Strength");
+        return strength.isValid() ? strength.toInt() + 1 : 0;
+    }
+    case LowestLoadPolicy: {
+        // this object does not count towards the load of its own modem
+        int load;
+        {
+            QMutexLocker locker(&selectionsLock);
+            load = selections.value(selectionKey(m_mm->connection(), modemPath));
+        }
+        if (m_if && modemPath == path())
+            load--;
+        return -load;
+    }
+    default:
+        return 0;
+    }
+}
 
 bool OfonoModem::isValid() const
 {
@@ -141,6 +501,11 @@ QString OfonoModem::path() const
     return m_if->path();
 }
 
+OfonoConnection OfonoModem::connection() const
+{
+    return m_if->connection();
+}
+
 QString OfonoModem::errorName() const
 {
     return m_if->errorMessage();
@@ -226,4 +591,22 @@ QStringList OfonoModem::interfaces() const
     return m_if->properties()["Interfaces"].value<QStringList>();
 }
 
+int OfonoModem::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    return m_if->addPropertyCallback(name, callback);
+}
+
+void OfonoModem::removePropertyCallback(int handle)
+{
+    m_if->removePropertyCallback(handle);
+}
 
+OfonoPropertySnapshot OfonoModem::snapshot() const
+{
+    return m_if->snapshot();
+}
+
+bool OfonoModem::isStale() const
+{
+    return m_if->isStale();
+}
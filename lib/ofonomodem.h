@@ -27,11 +27,22 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
+#include <QtCore/QElapsedTimer>
+#include <functional>
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
+#include "ofonoconnection.h"
 #include "libofono-qt_global.h"
 
 class OfonoModemManager;
 class OfonoInterface;
 
+//! Chooses one of the available modems for OfonoModem::CustomPolicy
+/*!
+ * Returning a path that is not among \a modems selects no modem.
+ */
+typedef std::function<QString (const QStringList &modems)> OfonoModemSelector;
+
 //! This class is used to access an oFono modem object and its properties
 /*!
  * oFono modem properties are documented in
@@ -66,15 +77,32 @@ public:
 
     //! How the modem object should select a modem
     enum SelectionSetting {
-    	AutomaticSelect,	/*!< Select the first available modem automatically;
-    				 * if that modem becomes unavailable, select the first available
-    				 * modem again. */
+    	AutomaticSelect,	/*!< Select an available modem automatically, by
+    				 * default the first one, see SelectionPolicy;
+    				 * if that modem becomes unavailable, select a modem again. */
     	ManualSelect 	/*!< Do not select a modem automatically,
     			 * use the modem path provided in the constructor, and do not
     			 * attempt to select another modem if the first one becomes 
     			 * unavailable. */
     };
 
+    //! Which of the available modems AutomaticSelect selects
+    /*!
+     * The policies that look at SIM and network properties warm up the
+     * property cache of all modems, see OfonoPropertyCache::warmUp(); until
+     * the properties have arrived, modems are treated as not qualifying.
+     */
+    enum SelectionPolicy {
+        FirstAvailablePolicy,	/*!< The first modem reported by oFono */
+        FirstPoweredPolicy,	/*!< The first powered modem */
+        SimPresentPolicy,	/*!< The first powered modem with a SIM card */
+        BestSignalPolicy,	/*!< The modem with the highest network signal strength */
+        LowestLoadPolicy,	/*!< The modem selected by the fewest modem objects
+    				 * of the process */
+        CustomPolicy		/*!< The modem chosen by the selector set with
+    				 * setSelector() */
+    };
+
     /*!
      * \param setting sets the modem selection policy for the object
      * \param modemPath if modem selection policy is ManualSelect, then this contains
@@ -82,6 +110,9 @@ public:
      */
     OfonoModem(SelectionSetting setting, const QString& modemPath, QObject *parent=0);
 
+    //! Constructs an AutomaticSelect modem object with a selection policy
+    explicit OfonoModem(SelectionPolicy policy, QObject *parent=0);
+
     ~OfonoModem();
 
     //! Returns true if D-Bus modem object exists.
@@ -89,6 +120,9 @@ public:
     
     //! Returns the D-Bus object path of the modem
     QString path() const;
+
+    //! Returns the D-Bus connection and service name of the modem, see OfonoConnection
+    OfonoConnection connection() const;
     
     //! Get the D-Bus error name of the last operation.
     /*!
@@ -119,7 +153,92 @@ public:
     QStringList features() const;
     QStringList interfaces() const;
 
+    //! Returns the interfaces of the modem as a bitset
+    /*!
+     * Bit n is set if the interface with interfaceBit() n is present.
+     * Interfaces beyond the first 64 distinct names seen by the process have
+     * no bit; hasInterface() still reports them.
+     */
+    quint64 interfaceBits() const {return m_interfaceBits;}
+
+    //! Returns the features of the modem as a bitset, see featureBit()
+    quint64 featureBits() const {return m_featureBits;}
+
+    //! Returns true if the modem has an interface, without scanning interfaces()
+    bool hasInterface(const QString &ifname) const;
+
+    //! Returns true if the modem has a feature, without scanning features()
+    bool hasFeature(const QString &feature) const;
+
+    //! Returns the bit of an interface name in interfaceBits(), or -1 if it has none
+    /*!
+     * Bits are assigned once per process, so they are the same for all modems.
+     * The common oFono interfaces always have a bit; other names get one when
+     * a modem first reports them, until 64 names have been seen. Looking up a
+     * name never assigns a bit.
+     *
+     * This method is thread-safe and does not lock.
+     */
+    static int interfaceBit(const QString &ifname);
+
+    //! Returns the interface name of a bit in interfaceBits()
+    static QString interfaceName(int bit);
+
+    //! Returns the bit of a feature name in featureBits(), or -1 if it has none, see interfaceBit()
+    static int featureBit(const QString &feature);
+
+    //! Registers a callback for changes of a modem property
+    /*!
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
+
+    //! Returns an immutable snapshot of all modem properties
+    /*!
+     * See OfonoInterface::snapshot().
+     */
+    OfonoPropertySnapshot snapshot() const;
+
+    //! Returns true if the modem properties were loaded from a saved cache and are not confirmed yet
+    /*!
+     * See OfonoPropertyCache::load().
+     */
+    bool isStale() const;
+
+    //! Returns the selection policy of AutomaticSelect
+    SelectionPolicy selectionPolicy() const {return m_policy;}
+
+    //! Changes the selection policy of AutomaticSelect
+    /*!
+     * The current modem is kept until it becomes unavailable; call
+     * reselect() to apply the policy immediately.
+     */
+    void setSelectionPolicy(SelectionPolicy policy);
+
+    //! Sets a selector and switches to CustomPolicy
+    void setSelector(const OfonoModemSelector &selector);
+
+    //! Returns the duration of the last failover in microseconds, or -1
+    /*!
+     * A failover lasts from the removal of the selected modem until the
+     * properties of the newly selected modem are available. A failover in
+     * which they could not be fetched is not measured, and neither is
+     * dropping to no modem when the last one goes away.
+     */
+    qint64 failoverLatency() const {return m_failoverLatency;}
+
 public Q_SLOTS:
+    //! Selects a modem according to the selection policy now
+    /*!
+     * This has no effect with ManualSelect. Switching to another modem does
+     * not block; the modem properties are taken from the cache or fetched
+     * asynchronously.
+     */
+    void reselect();
+
     void setPowered(bool powered);
     void setOnline(bool online);
     void setLockdown(bool lockdown);
@@ -148,20 +267,58 @@ Q_SIGNALS:
     void featuresChanged(const QStringList &features);
     void interfacesChanged(const QStringList &interfaces);
 
+    //! Issued when an interface has been added to the modem
+    void interfaceAppeared(const QString &ifname);
+    //! Issued when an interface has been removed from the modem
+    /*!
+     * This is also issued for all interfaces when another modem is selected
+     * or oFono goes away; the interfaces of the new modem appear once its
+     * properties are available.
+     */
+    void interfaceDisappeared(const QString &ifname);
+    //! Issued before interfacesChanged() with the new bitset and the bits that have changed
+    void interfaceBitsChanged(quint64 bits, quint64 changed);
+
+    //! Issued after AutomaticSelect has switched away from a modem that became unavailable
+    /*!
+     * \param usecs time from the removal until the properties of the new
+     * modem were available, see failoverLatency()
+     */
+    void failoverCompleted(const QString &oldPath, const QString &newPath, qint64 usecs);
+
 
 private Q_SLOTS:
     void propertyChanged(const QString &property, const QVariant &value);
     void setPropertyFailed(const QString& property);
     void modemAdded(const QString &modem);
     void modemRemoved(const QString &modem);
+    void propertiesReady(const QString &modemPath, bool success);
+    void emitFailoverCompleted();
+    void onServiceLost();
 
 private:
+    void init(const QString &modemPath);
     void modemsChanged();
+    QString selectModem() const;
+    int selectionScore(const QString &modemPath) const;
+    void switchTo(const QString &modemPath, bool failover);
+    void warmUpModems();
+    void updateInterfaces(const QStringList &interfaces);
+    void clearBits();
 
 private:
     OfonoModemManager *m_mm;
     OfonoInterface *m_if;
     SelectionSetting m_selectionSetting;
     bool m_isValid;
+    SelectionPolicy m_policy;
+    OfonoModemSelector m_selector;
+    QElapsedTimer m_failoverTimer;
+    bool m_failoverPending;
+    QString m_failoverFrom;
+    qint64 m_failoverLatency;
+    quint64 m_interfaceBits;
+    quint64 m_featureBits;
+    QStringList m_extraInterfaces;
 };
 #endif
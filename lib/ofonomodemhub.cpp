@@ -0,0 +1,168 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtCore/QObject>
+
+#include "ofonomodemhub.h"
+#include "ofonocallbarring.h"
+#include "ofonocallforwarding.h"
+#include "ofonocallmeter.h"
+#include "ofonocallsettings.h"
+#include "ofonocallvolume.h"
+#include "ofonocellbroadcast.h"
+#include "ofonoconnman.h"
+#include "ofonomessagemanager.h"
+#include "ofonomessagewaiting.h"
+#include "ofononetworkregistration.h"
+#include "ofonophonebook.h"
+#include "ofonoradiosettings.h"
+#include "ofonosimmanager.h"
+#include "ofonosupplementaryservices.h"
+#include "ofonovoicecallmanager.h"
+
+OfonoModemHub::OfonoModemHub(OfonoModem::SelectionSetting setting, const QString &modemPath, QObject *parent)
+    : QObject(parent)
+{
+    m_modem = new OfonoModem(setting, modemPath, this);
+    connect(m_modem, SIGNAL(interfaceDisappeared(const QString&)),
+            this, SLOT(interfaceDisappeared(const QString&)));
+    connect(m_modem, SIGNAL(validityChanged(bool)),
+            this, SLOT(modemValidityChanged(bool)));
+}
+
+OfonoModemHub::~OfonoModemHub()
+{
+    // the interface objects refer to the modem until they are gone
+    qDeleteAll(m_interfaces);
+    m_interfaces.clear();
+}
+
+template <class T> T *OfonoModemHub::load(const QString &ifname)
+{
+    OfonoModemInterface *object = m_interfaces.value(ifname);
+    if (!object) {
+        if (!m_modem->isValid() || !m_modem->hasInterface(ifname))
+            return 0;
+        object = new T(m_modem, this);
+        m_interfaces.insert(ifname, object);
+        emit interfaceLoaded(ifname);
+    }
+    return static_cast<T*>(object);
+}
+
+void OfonoModemHub::unload(const QString &ifname)
+{
+    OfonoModemInterface *object = m_interfaces.take(ifname);
+    if (!object)
+        return;
+    emit interfaceUnloaded(ifname);
+    object->deleteLater();
+}
+
+void OfonoModemHub::interfaceDisappeared(const QString &ifname)
+{
+    unload(ifname);
+}
+
+void OfonoModemHub::modemValidityChanged(bool validity)
+{
+    if (validity)
+        return;
+    foreach (QString ifname, m_interfaces.keys())
+        unload(ifname);
+}
+
+OfonoCallBarring *OfonoModemHub::callBarring()
+{
+    return load<OfonoCallBarring>("org.ofono.CallBarring");
+}
+
+OfonoCallForwarding *OfonoModemHub::callForwarding()
+{
+    return load<OfonoCallForwarding>("org.ofono.CallForwarding");
+}
+
+OfonoCallMeter *OfonoModemHub::callMeter()
+{
+    return load<OfonoCallMeter>("org.ofono.CallMeter");
+}
+
+OfonoCallSettings *OfonoModemHub::callSettings()
+{
+    return load<OfonoCallSettings>("org.ofono.CallSettings");
+}
+
+OfonoCallVolume *OfonoModemHub::callVolume()
+{
+    return load<OfonoCallVolume>("org.ofono.CallVolume");
+}
+
+OfonoCellBroadcast *OfonoModemHub::cellBroadcast()
+{
+    return load<OfonoCellBroadcast>("org.ofono.CellBroadcast");
+}
+
+OfonoConnMan *OfonoModemHub::connMan()
+{
+    return load<OfonoConnMan>("org.ofono.ConnectionManager");
+}
+
+OfonoMessageManager *OfonoModemHub::messageManager()
+{
+    return load<OfonoMessageManager>("org.ofono.MessageManager");
+}
+
+OfonoMessageWaiting *OfonoModemHub::messageWaiting()
+{
+    return load<OfonoMessageWaiting>("org.ofono.MessageWaiting");
+}
+
+OfonoNetworkRegistration *OfonoModemHub::networkRegistration()
+{
+    return load<OfonoNetworkRegistration>("org.ofono.NetworkRegistration");
+}
+
+OfonoPhonebook *OfonoModemHub::phonebook()
+{
+    return load<OfonoPhonebook>("org.ofono.Phonebook");
+}
+
+OfonoRadioSettings *OfonoModemHub::radioSettings()
+{
+    return load<OfonoRadioSettings>("org.ofono.RadioSettings");
+}
+
+OfonoSimManager *OfonoModemHub::simManager()
+{
+    return load<OfonoSimManager>("org.ofono.SimManager");
+}
+
+OfonoSupplementaryServices *OfonoModemHub::supplementaryServices()
+{
+    return load<OfonoSupplementaryServices>("org.ofono.SupplementaryServices");
+}
+
+OfonoVoiceCallManager *OfonoModemHub::voiceCallManager()
+{
+    return load<OfonoVoiceCallManager>("org.ofono.VoiceCallManager");
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOMODEMHUB_H
+#define OFONOMODEMHUB_H
+
+#include <QtCore/QObject>
+#include <QHash>
+#include <QStringList>
+#include "ofonomodem.h"
+#include "libofono-qt_global.h"
+
+class OfonoModemInterface;
+class OfonoCallBarring;
+class OfonoCallForwarding;
+class OfonoCallMeter;
+class OfonoCallSettings;
+class OfonoCallVolume;
+class OfonoCellBroadcast;
+class OfonoConnMan;
+class OfonoMessageManager;
+class OfonoMessageWaiting;
+class OfonoNetworkRegistration;
+class OfonoPhonebook;
+class OfonoRadioSettings;
+class OfonoSimManager;
+class OfonoSupplementaryServices;
+class OfonoVoiceCallManager;
+
+//! Lazily constructed interface objects of one modem
+/*!
+ * Constructing an interface object such as OfonoSimManager standalone also
+ * constructs its own OfonoModem and OfonoModemManager. The hub instead owns
+ * a single modem object, and constructs each interface object on top of it
+ * the first time it is accessed, so applications pay only for the
+ * interfaces they use.
+ *
+ * The accessors return 0 if the modem does not currently have the interface.
+ * When an interface disappears from the modem, or the modem itself goes
+ * away, the interface object is scheduled for deletion after
+ * interfaceUnloaded() is issued; it is constructed again on the next access
+ * once the interface is back.
+ */
+class OFONO_QT_EXPORT OfonoModemHub : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * \param setting modem selection setting, see OfonoModem
+     * \param modemPath path to the modem (may not be significant, depending on setting)
+     */
+    OfonoModemHub(OfonoModem::SelectionSetting setting, const QString &modemPath, QObject *parent=0);
+    ~OfonoModemHub();
+
+    //! Returns the modem object shared by all interface objects
+    OfonoModem *modem() const {return m_modem;}
+
+    //! Returns true if the interface object of an interface has been constructed
+    bool isLoaded(const QString &ifname) const {return m_interfaces.contains(ifname);}
+
+    //! Returns the names of the interfaces whose objects have been constructed
+    QStringList loadedInterfaces() const {return m_interfaces.keys();}
+
+    OfonoCallBarring *callBarring();
+    OfonoCallForwarding *callForwarding();
+    OfonoCallMeter *callMeter();
+    OfonoCallSettings *callSettings();
+    OfonoCallVolume *callVolume();
+    OfonoCellBroadcast *cellBroadcast();
+    OfonoConnMan *connMan();
+    OfonoMessageManager *messageManager();
+    OfonoMessageWaiting *messageWaiting();
+    OfonoNetworkRegistration *networkRegistration();
+    OfonoPhonebook *phonebook();
+    OfonoRadioSettings *radioSettings();
+    OfonoSimManager *simManager();
+    OfonoSupplementaryServices *supplementaryServices();
+    OfonoVoiceCallManager *voiceCallManager();
+
+Q_SIGNALS:
+    //! Issued when the object of an interface has been constructed
+    void interfaceLoaded(const QString &ifname);
+
+    //! Issued before the object of an interface that has disappeared is deleted
+    void interfaceUnloaded(const QString &ifname);
+
+private Q_SLOTS:
+    void interfaceDisappeared(const QString &ifname);
+    void modemValidityChanged(bool validity);
+
+private:
+    template <class T> T *load(const QString &ifname);
+    void unload(const QString &ifname);
+
+private:
+    OfonoModem *m_modem;
+    QHash<QString, OfonoModemInterface*> m_interfaces;
+};
+
+#endif
@@ -33,11 +33,28 @@ OfonoModemInterface::OfonoModemInterface(OfonoModem::SelectionSetting modemSetti
 {
 
     m_m = new OfonoModem(modemSetting, modemPath, this);
+    initInterface(ifname, propertySetting);
+}
+
+OfonoModemInterface::OfonoModemInterface(OfonoModem *modem, const QString& ifname, OfonoGetPropertySetting propertySetting, QObject *parent)
+    : QObject(parent), m_m(modem)
+{
+    initInterface(ifname, propertySetting);
+}
+
+void OfonoModemInterface::initInterface(const QString& ifname, OfonoGetPropertySetting propertySetting)
+{
     connect(m_m, SIGNAL(validityChanged(bool)), this, SLOT(modemValidityChanged(bool)));
-    connect(m_m, SIGNAL(interfacesChanged(QStringList)), this, SLOT(interfacesChanged(QStringList)));
+    connect(m_m, SIGNAL(interfaceBitsChanged(quint64, quint64)), this, SLOT(interfaceBitsChanged(quint64, quint64)));
+    m_bit = OfonoModem::interfaceBit(ifname);
 
+    // a shared modem may belong to another connection than the current one
+    OfonoConnectionScope scope(m_m->connection());
     m_if = new OfonoInterface(m_m->path(), ifname, propertySetting, this);
-    connect(m_m, SIGNAL(pathChanged(QString)), m_if, SLOT(setPath(const QString&)));
+    // switching modems must not block on GetProperties
+    connect(m_m, SIGNAL(pathChanged(QString)), m_if, SLOT(setPathAsync(const QString&)));
+    connect(m_if, SIGNAL(propertyTriggered(int, const QString&, const QVariant&)),
+            this, SIGNAL(propertyTriggered(int, const QString&, const QVariant&)));
     m_isValid = checkValidity();
 }
 
@@ -57,7 +74,14 @@ OfonoModem* OfonoModemInterface::modem() const
 
 bool OfonoModemInterface::checkValidity()
 {
-    return (m_m->isValid() && m_m->interfaces().contains(m_if->ifname()));
+    if (!m_m->isValid())
+        return false;
+    // the interface may have got a bit since the object was created
+    if (m_bit < 0)
+        m_bit = OfonoModem::interfaceBit(m_if->ifname());
+    if (m_bit < 0)
+        return m_m->hasInterface(m_if->ifname());
+    return m_m->interfaceBits() & (Q_UINT64_C(1) << m_bit);
 }
 
 void OfonoModemInterface::updateValidity()
@@ -73,8 +97,11 @@ void OfonoModemInterface::modemValidityChanged(bool /*validity*/)
     updateValidity();
 }
 
-void OfonoModemInterface::interfacesChanged(const QStringList& /*interfaces*/)
+void OfonoModemInterface::interfaceBitsChanged(quint64 /*bits*/, quint64 changed)
 {
+    // interfaces without a bit are signalled with an empty change
+    if (m_bit >= 0 && !(changed & (Q_UINT64_C(1) << m_bit)))
+        return;
     updateValidity();
 }
 
@@ -93,3 +120,33 @@ QString OfonoModemInterface::errorMessage() const
     return m_if->errorMessage();
 }
 
+int OfonoModemInterface::addPropertyTrigger(const OfonoPropertyTrigger& trigger)
+{
+    return m_if->addPropertyTrigger(trigger);
+}
+
+void OfonoModemInterface::removePropertyTrigger(int id)
+{
+    m_if->removePropertyTrigger(id);
+}
+
+int OfonoModemInterface::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    return m_if->addPropertyCallback(name, callback);
+}
+
+void OfonoModemInterface::removePropertyCallback(int handle)
+{
+    m_if->removePropertyCallback(handle);
+}
+
+OfonoPropertySnapshot OfonoModemInterface::snapshot() const
+{
+    return m_if->snapshot();
+}
+
+bool OfonoModemInterface::isStale() const
+{
+    return m_if->isStale();
+}
+
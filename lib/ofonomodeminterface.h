@@ -28,6 +28,9 @@
 #include <QStringList>
 #include "ofonomodem.h"
 #include "ofonopropertysetting.h"
+#include "ofonopropertytrigger.h"
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
 #include "libofono-qt_global.h"
 
 class OfonoInterface;
@@ -57,6 +60,17 @@ public:
      * \param propertySetting oFono d-bus properties setting
      */
     OfonoModemInterface(OfonoModem::SelectionSetting modemSetting, const QString& modemPath, const QString& ifname, OfonoGetPropertySetting propertySetting, QObject *parent=0);
+
+    //! Construct a modem interface object on top of an existing modem object
+    /*!
+     * The modem object is shared, not owned; it must outlive this object.
+     * See OfonoModemHub.
+     *
+     * \param modem modem object
+     * \param ifname d-bus interface name
+     * \param propertySetting oFono d-bus properties setting
+     */
+    OfonoModemInterface(OfonoModem *modem, const QString& ifname, OfonoGetPropertySetting propertySetting, QObject *parent=0);
     ~OfonoModemInterface();
 
     //! Check that the modem interface object is valid
@@ -89,6 +103,62 @@ public:
      */
     QString errorMessage() const;
 
+    //! Adds a trigger on a property of the interface
+    /*!
+     * Only the property updates that complete the transition described by
+     * the trigger are reported, via propertyTriggered(). For example,
+     * OfonoNetworkRegistration can report "Strength" crossing 20 with
+     * a hysteresis of 5, or "Status" leaving "registered":
+     *
+     * \code
+     * netreg->addPropertyTrigger(OfonoPropertyTrigger("Strength", OfonoPropertyTrigger::Crosses, 20, 5));
+     * netreg->addPropertyTrigger(OfonoPropertyTrigger("Status", OfonoPropertyTrigger::Leaves, QString("registered")));
+     * \endcode
+     *
+     * Returns an id that identifies the trigger in propertyTriggered().
+     */
+    int addPropertyTrigger(const OfonoPropertyTrigger &trigger);
+
+    //! Removes a trigger added with addPropertyTrigger()
+    void removePropertyTrigger(int id);
+
+    //! Registers a callback for changes of a property of the interface
+    /*!
+     * This is a lightweight alternative to connecting to the change
+     * notification signals: the callback is invoked directly with the new
+     * value, for example
+     *
+     * \code
+     * netreg->addPropertyCallback("Strength", [](const QVariant &v) { update(v.toUInt()); });
+     * \endcode
+     *
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
+
+    //! Returns an immutable snapshot of all properties of the interface
+    /*!
+     * All values in a snapshot come from the same update, so related
+     * properties, such as MobileCountryCode, MobileNetworkCode and Name of
+     * the network registration, are always consistent with each other.
+     * The snapshot version increases with every update.
+     *
+     * See OfonoInterface::snapshot().
+     */
+    OfonoPropertySnapshot snapshot() const;
+
+    //! Returns true if the properties were loaded from a saved cache and are not confirmed yet
+    /*!
+     * Stale properties are served immediately at startup and reconciled
+     * with oFono in the background, see OfonoPropertyCache::load().
+     * propertyChanged() and the specific change signals are issued for
+     * every value that turns out to be different.
+     */
+    bool isStale() const;
+
 Q_SIGNALS:
     //! Interface validity has changed
     /*!
@@ -98,13 +168,17 @@ Q_SIGNALS:
      */
     void validityChanged(bool validity);
 
+    //! A property update has matched a trigger added with addPropertyTrigger()
+    void propertyTriggered(int id, const QString &name, const QVariant &value);
+
 private:
+    void initInterface(const QString &ifname, OfonoGetPropertySetting propertySetting);
     bool checkValidity();
     void updateValidity();
 
 private Q_SLOTS:
     void modemValidityChanged(bool validity);
-    void interfacesChanged(const QStringList &interfaces);
+    void interfaceBitsChanged(quint64 bits, quint64 changed);
 
 protected:
     OfonoInterface *m_if;
@@ -112,5 +186,6 @@ protected:
 private:
     OfonoModem *m_m;
     bool m_isValid;
+    int m_bit;
 };
 #endif
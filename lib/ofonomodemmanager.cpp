@@ -26,6 +26,9 @@
 
 #include "ofonomodemmanager.h"
 #include "ofonointerface.h"
+#include "ofonoeventbus.h"
+#include "ofonoservicetracker.h"
+#include "ofonopropertycache.h"
 
 struct OfonoModemStruct {
     QDBusObjectPath path;
@@ -52,7 +55,7 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, OfonoModemStruct
 }
 
 OfonoModemManager::OfonoModemManager(QObject *parent)
-    : QObject(parent)
+    : QObject(parent), m_connection(OfonoConnection::current())
 {
     QDBusReply<OfonoModemList> reply;
     OfonoModemList modems;
@@ -62,23 +65,32 @@ OfonoModemManager::OfonoModemManager(QObject *parent)
     qDBusRegisterMetaType<OfonoModemStruct>();
     qDBusRegisterMetaType<OfonoModemList>();
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    // the cache must be watching for changes before the modem properties are seeded
+    OfonoPropertyCache *cache = OfonoPropertyCache::forConnection(m_connection);
+
+    request = QDBusMessage::createMethodCall(m_connection.service(),
 					     "/", "org.ofono.Manager",
 					     "GetModems");
-    reply = QDBusConnection::systemBus().call(request);
+    reply = m_connection.bus().call(request);
 
     modems = reply;
     foreach(OfonoModemStruct modem, modems) {
-	m_modems << modem.path.path();
+	m_modems.insert(modem.path.path());
+	cache->seed(modem.path.path(), "org.ofono.Modem", modem.properties);
+	OfonoEventBus::instance()->publish(OfonoEvent::ModemAdded, modem.path.path(),
+					   "org.ofono.Modem", modem.properties);
     }
 
-    QDBusConnection::systemBus().connect("org.ofono","/","org.ofono.Manager",
+    m_connection.bus().connect(m_connection.service(),"/","org.ofono.Manager",
 					 "ModemAdded", this, 
 					 SLOT(onModemAdded(const QDBusObjectPath&, const QVariantMap&)));
-    QDBusConnection::systemBus().connect("org.ofono","/","org.ofono.Manager",
+    m_connection.bus().connect(m_connection.service(),"/","org.ofono.Manager",
 					 "ModemRemoved", this, 
 					 SLOT(onModemRemoved(const QDBusObjectPath&)));
 
+    m_tracker = OfonoServiceTracker::forConnection(m_connection);
+    connect(m_tracker, SIGNAL(serviceLost()), this, SLOT(onServiceLost()));
+    connect(m_tracker, SIGNAL(serviceReturned()), this, SLOT(onServiceReturned()));
 }
 
 OfonoModemManager::~OfonoModemManager()
@@ -87,19 +99,53 @@ OfonoModemManager::~OfonoModemManager()
 
 QStringList OfonoModemManager::modems() const
 {
-    return m_modems;
+    return m_modems.toList();
 }
 
-void OfonoModemManager::onModemAdded(const QDBusObjectPath& path, const QVariantMap& /*map*/)
+void OfonoModemManager::onModemAdded(const QDBusObjectPath& path, const QVariantMap& map)
 {
-    m_modems << path.path();
+    // the modem may already be known from a resync after a service restart
+    if (!m_modems.insert(path.path()))
+        return;
+    OfonoPropertyCache::forConnection(m_connection)->seed(path.path(), "org.ofono.Modem", map);
+    OfonoEventBus::instance()->publish(OfonoEvent::ModemAdded, path.path(), "org.ofono.Modem", map);
     emit modemAdded(path.path());
 }
 
 void OfonoModemManager::onModemRemoved(const QDBusObjectPath& path)
 {
-    m_modems.removeAll(path.path()); 
+    m_modems.remove(path.path());
+    OfonoPropertyCache::forConnection(m_connection)->forget(path.path());
+    OfonoEventBus::instance()->publish(OfonoEvent::ModemRemoved, path.path(), "org.ofono.Modem");
     emit modemRemoved(path.path());
 }
 
+void OfonoModemManager::onServiceLost()
+{
+    foreach (QString modem, m_modems.toList())
+        onModemRemoved(QDBusObjectPath(modem));
+}
 
+void OfonoModemManager::onServiceReturned()
+{
+    QDBusMessage request = QDBusMessage::createMethodCall(m_connection.service(),
+                                                          "/", "org.ofono.Manager",
+                                                          "GetModems");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.bus().asyncCall(request), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(resyncModemsFinished(QDBusPendingCallWatcher*)));
+    m_tracker->addFetch(watcher);
+}
+
+void OfonoModemManager::resyncModemsFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<OfonoModemList> reply = *watcher;
+    watcher->deleteLater();
+
+    if (!reply.isError()) {
+        foreach (OfonoModemStruct modem, reply.value()) {
+            if (!m_modems.contains(modem.path.path()))
+                onModemAdded(modem.path, modem.properties);
+        }
+    }
+}
@@ -28,8 +28,13 @@
 #include <QVariant>
 #include <QDBusObjectPath>
 #include <QStringList>
+#include "ofonoconnection.h"
+#include "ofonopathset.h"
 #include "libofono-qt_global.h"
 
+class OfonoServiceTracker;
+class QDBusPendingCallWatcher;
+
 //! Provides access to the list of available modems and changes in that list.
 class OFONO_QT_EXPORT OfonoModemManager : public QObject {
 
@@ -44,6 +49,12 @@ public:
     //! Returns a list of d-bus object paths that represent available modems
     Q_INVOKABLE QStringList modems() const;
 
+    //! Returns the available modems as a set, for constant-time lookups
+    const OfonoPathSet &modemPaths() const {return m_modems;}
+
+    //! Returns the connection the manager uses, see OfonoConnection
+    OfonoConnection connection() const {return m_connection;}
+
 Q_SIGNALS:
     //! Issued when a modem has been added
     void modemAdded(const QString &modemPath);
@@ -54,9 +65,14 @@ Q_SIGNALS:
 private Q_SLOTS:
     void onModemAdded(const QDBusObjectPath &path, const QVariantMap &map);
     void onModemRemoved(const QDBusObjectPath &path);
+    void onServiceLost();
+    void onServiceReturned();
+    void resyncModemsFinished(QDBusPendingCallWatcher *watcher);
 
 private:
-    QStringList m_modems;
+    OfonoConnection m_connection;
+    OfonoPathSet m_modems;
+    OfonoServiceTracker *m_tracker;
 };
 
 #endif
@@ -50,11 +50,11 @@ void OfonoNetworkOperator::registerOp()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Register");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(registerResp()),
 					SLOT(registerErr(const QDBusError&)),
 					REGISTER_TIMEOUT);
@@ -133,3 +133,17 @@ QString OfonoNetworkOperator::errorMessage() const
     return m_if->errorMessage();
 }
 
+int OfonoNetworkOperator::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    return m_if->addPropertyCallback(name, callback);
+}
+
+void OfonoNetworkOperator::removePropertyCallback(int handle)
+{
+    m_if->removePropertyCallback(handle);
+}
+
+OfonoPropertySnapshot OfonoNetworkOperator::snapshot() const
+{
+    return m_if->snapshot();
+}
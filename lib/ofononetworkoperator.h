@@ -30,6 +30,8 @@
 #include <QStringList>
 #include <QDBusError>
 
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
 #include "libofono-qt_global.h"
 
 class OfonoInterface;
@@ -85,6 +87,21 @@ public:
     QStringList technologies() const;
     QString additionalInfo() const;
 
+    //! Registers a callback for changes of a network operator property
+    /*!
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
+
+    //! Returns an immutable snapshot of all operator properties
+    /*!
+     * See OfonoInterface::snapshot().
+     */
+    OfonoPropertySnapshot snapshot() const;
+
 public Q_SLOTS:
     void registerOp();
     
@@ -49,6 +49,17 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, OfonoOperatorStru
 
 OfonoNetworkRegistration::OfonoNetworkRegistration(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.NetworkRegistration", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoNetworkRegistration::OfonoNetworkRegistration(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.NetworkRegistration", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoNetworkRegistration::init()
 {
     qDBusRegisterMetaType<OfonoOperatorStruct>();
     qDBusRegisterMetaType<OfonoOperatorList>();
@@ -65,11 +76,11 @@ void OfonoNetworkRegistration::registerOp()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Register");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(registerResp()),
 					SLOT(registerErr(const QDBusError&)),
 					REGISTER_TIMEOUT);
@@ -79,11 +90,11 @@ void OfonoNetworkRegistration::scan()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Scan");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(scanResp(OfonoOperatorList)),
 					SLOT(scanErr(const QDBusError&)),
 					REGISTER_TIMEOUT);
@@ -93,11 +104,11 @@ void OfonoNetworkRegistration::getOperators()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "GetOperators");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(getOperatorsResp(OfonoOperatorList)),
 					SLOT(getOperatorsErr(const QDBusError&)),
 					SCAN_TIMEOUT);
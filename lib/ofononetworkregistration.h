@@ -61,6 +61,8 @@ class OFONO_QT_EXPORT OfonoNetworkRegistration : public OfonoModemInterface
     
 public:
     OfonoNetworkRegistration(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoNetworkRegistration(OfonoModem *modem, QObject *parent=0);
     ~OfonoNetworkRegistration();
     
     /* Properties */
@@ -106,6 +108,7 @@ private Q_SLOTS:
     void scanErr(QDBusError error);
 
 private:
+    void init();
 
 };
 
@@ -0,0 +1,102 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "ofonopathset.h"
+
+// compacting fewer holes than this is not worth it
+#define MIN_HOLES_TO_COMPACT 16
+
+OfonoPathSet::OfonoPathSet()
+    : m_holes(0), m_listValid(true)
+{
+}
+
+OfonoPathSet::OfonoPathSet(const QStringList &paths)
+    : m_holes(0), m_listValid(false)
+{
+    foreach (QString path, paths)
+        insert(path);
+}
+
+bool OfonoPathSet::insert(const QString &path)
+{
+    // a null string marks a removed slot
+    if (path.isNull() || m_index.contains(path))
+        return false;
+    m_index.insert(path, m_slots.count());
+    m_slots.append(path);
+    m_listValid = false;
+    return true;
+}
+
+bool OfonoPathSet::remove(const QString &path)
+{
+    QHash<QString, int>::iterator i = m_index.find(path);
+    if (i == m_index.end())
+        return false;
+    // a null string marks the hole
+    m_slots[i.value()] = QString();
+    m_index.erase(i);
+    m_holes++;
+    m_listValid = false;
+    if (m_holes >= MIN_HOLES_TO_COMPACT && m_holes * 2 >= m_slots.count())
+        compact();
+    return true;
+}
+
+void OfonoPathSet::clear()
+{
+    m_slots.clear();
+    m_index.clear();
+    m_holes = 0;
+    m_list.clear();
+    m_listValid = true;
+}
+
+void OfonoPathSet::compact()
+{
+    QVector<QString> compacted;
+    compacted.reserve(m_index.count());
+    foreach (QString path, m_slots) {
+        if (!path.isNull()) {
+            m_index[path] = compacted.count();
+            compacted.append(path);
+        }
+    }
+    m_slots = compacted;
+    m_holes = 0;
+}
+
+QStringList OfonoPathSet::toList() const
+{
+    if (!m_listValid) {
+        m_list.clear();
+        m_list.reserve(m_index.count());
+        foreach (QString path, m_slots) {
+            if (!path.isNull())
+                m_list << path;
+        }
+        m_listValid = true;
+    }
+    return m_list;
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOPATHSET_H
+#define OFONOPATHSET_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include "libofono-qt_global.h"
+
+//! Insertion-ordered set of D-Bus object paths
+/*!
+ * Adding, removing and looking up a path take constant time. A removed path
+ * leaves a hole that is skipped, and the holes are compacted once they make
+ * up half of the storage. toList() returns the paths in insertion order; the
+ * list is rebuilt only when the set has changed since the previous call, and
+ * returning it by value does not copy the paths.
+ *
+ * This class is not thread-safe.
+ */
+class OFONO_QT_EXPORT OfonoPathSet
+{
+public:
+    OfonoPathSet();
+    //! Constructs a set of the given paths, in their order, without duplicates
+    explicit OfonoPathSet(const QStringList &paths);
+
+    //! Returns true if the set contains \a path
+    bool contains(const QString &path) const {return m_index.contains(path);}
+
+    //! Returns the number of paths in the set
+    int count() const {return m_index.count();}
+
+    //! Returns true if the set contains no paths
+    bool isEmpty() const {return m_index.isEmpty();}
+
+    //! Adds a path at the end, returns false if it was already there or is null
+    bool insert(const QString &path);
+
+    //! Removes a path, returns false if it was not there
+    bool remove(const QString &path);
+
+    //! Removes all paths
+    void clear();
+
+    //! Returns the paths in insertion order
+    QStringList toList() const;
+
+private:
+    void compact();
+
+private:
+    QVector<QString> m_slots;
+    QHash<QString, int> m_index;
+    int m_holes;
+    mutable QStringList m_list;
+    mutable bool m_listValid;
+};
+
+#endif
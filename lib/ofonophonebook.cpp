@@ -35,6 +35,11 @@ OfonoPhonebook::OfonoPhonebook(OfonoModem::SelectionSetting modemSetting, const
 
 }
 
+OfonoPhonebook::OfonoPhonebook(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.Phonebook", OfonoGetAllOnFirstRequest, parent)
+{
+}
+
 OfonoPhonebook::~OfonoPhonebook()
 {
 }
@@ -43,12 +48,12 @@ void OfonoPhonebook::import()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Import");
     request.setArguments(QList<QVariant>());
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(importResp(QString)),
 					SLOT(importErr(const QDBusError&)),
 					IMPORT_TIMEOUT);
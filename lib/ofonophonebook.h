@@ -42,6 +42,8 @@ Q_OBJECT
 public:
 
     OfonoPhonebook(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoPhonebook(OfonoModem *modem, QObject *parent=0);
 
     ~OfonoPhonebook();
 
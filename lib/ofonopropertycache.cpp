@@ -0,0 +1,469 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtDBus/QtDBus>
+#include <QtCore/QObject>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimer>
+
+#include "ofonopropertycache.h"
+#include "ofonoservicetracker.h"
+
+#define GET_PROPERTIES_TIMEOUT 300000
+
+#define CACHE_FILE_MAGIC 0x4f464e43
+#define CACHE_FILE_VERSION 1
+
+static QHash<QString, OfonoPropertyCache*> caches;
+
+OfonoPropertyCache *OfonoPropertyCache::forConnection(const OfonoConnection &connection)
+{
+    QString id = connection.bus().name() + '\n' + connection.service();
+    OfonoPropertyCache *cache = caches.value(id);
+    if (!cache) {
+        cache = new OfonoPropertyCache(connection);
+        caches.insert(id, cache);
+    }
+    return cache;
+}
+
+OfonoPropertyCache::OfonoPropertyCache(const OfonoConnection &connection)
+    : QObject(0), m_connection(connection), m_saveTimer(0)
+{
+    connect(OfonoServiceTracker::forConnection(connection), SIGNAL(serviceLost()),
+            this, SLOT(onServiceLost()));
+}
+
+OfonoPropertyCache::~OfonoPropertyCache()
+{
+}
+
+void OfonoPropertyCache::warmUp(const QString &modemPath)
+{
+    if (m_warming.contains(modemPath))
+        return;
+    // the extra count is released below, once all calls have been issued
+    m_warming.insert(modemPath, 1);
+
+    QString modemKey = key(modemPath, "org.ofono.Modem");
+    if (m_entries.contains(modemKey) && !m_entries[modemKey].watcher)
+        fetchInterfaces(modemPath);
+    else
+        startFetch(modemPath, "org.ofono.Modem", modemPath);
+    fetchDone(modemPath);
+}
+
+void OfonoPropertyCache::fetchInterfaces(const QString &modemPath)
+{
+    QStringList interfaces = m_entries.value(key(modemPath, "org.ofono.Modem")).properties["Interfaces"].toStringList();
+    foreach (QString ifname, interfaces)
+        startFetch(modemPath, ifname, modemPath);
+}
+
+void OfonoPropertyCache::startFetch(const QString &path, const QString &ifname, const QString &warmup)
+{
+    QString k = key(path, ifname);
+    if (m_entries.contains(k))
+        return;
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_connection.service(),
+                                                          path, ifname,
+                                                          "GetProperties");
+    Entry entry;
+    entry.watcher = new QDBusPendingCallWatcher(m_connection.bus().asyncCall(request, GET_PROPERTIES_TIMEOUT), this);
+    entry.warmup = warmup;
+    connect(entry.watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(fetchFinished(QDBusPendingCallWatcher*)));
+    m_entries.insert(k, entry);
+    entryAdded(k);
+    m_watchers.insert(entry.watcher, k);
+    if (!warmup.isEmpty())
+        m_warming[warmup]++;
+}
+
+void OfonoPropertyCache::fetchFinished(QDBusPendingCallWatcher *watcher)
+{
+    // the reply may already have been taken by fetch()
+    if (!m_watchers.contains(watcher))
+        return;
+    handleReply(m_watchers.take(watcher), watcher);
+}
+
+void OfonoPropertyCache::handleReply(const QString &k, QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    watcher->deleteLater();
+
+    QString warmup = m_entries[k].warmup;
+    if (reply.isError()) {
+        // e.g. an interface without properties
+        m_entries.remove(k);
+        entryRemoved(k);
+    } else {
+        Entry &entry = m_entries[k];
+        entry.properties = reply.value();
+        entry.watcher = 0;
+        entry.warmup = QString();
+        if (!warmup.isEmpty() && k == key(warmup, "org.ofono.Modem"))
+            fetchInterfaces(warmup);
+    }
+    if (!warmup.isEmpty())
+        fetchDone(warmup);
+}
+
+void OfonoPropertyCache::fetchDone(const QString &warmup)
+{
+    if (!m_warming.contains(warmup))
+        return;
+    if (--m_warming[warmup] == 0) {
+        m_warming.remove(warmup);
+        emit warmedUp(warmup);
+    }
+}
+
+bool OfonoPropertyCache::contains(const QString &path, const QString &ifname) const
+{
+    QHash<QString, Entry>::const_iterator i = m_entries.find(key(path, ifname));
+    return i != m_entries.end() && !i.value().watcher;
+}
+
+bool OfonoPropertyCache::fetch(const QString &path, const QString &ifname, QVariantMap &properties, bool *stale)
+{
+    QString k = key(path, ifname);
+    if (!m_entries.contains(k))
+        return false;
+
+    QDBusPendingCallWatcher *watcher = m_entries[k].watcher;
+    if (watcher) {
+        // waitForFinished() issues finished() right away, so the reply is
+        // taken from fetchFinished() first to be handled only once here
+        m_watchers.remove(watcher);
+        disconnect(watcher, 0, this, 0);
+        // the other calls of a warm-up are still in flight meanwhile
+        watcher->waitForFinished();
+        handleReply(k, watcher);
+        if (!m_entries.contains(k))
+            return false;
+    }
+    properties = m_entries[k].properties;
+    if (stale)
+        *stale = m_entries[k].stale;
+    return true;
+}
+
+void OfonoPropertyCache::seed(const QString &path, const QString &ifname, const QVariantMap &properties)
+{
+    QString k = key(path, ifname);
+    if (!m_entries.contains(k))
+        entryAdded(k);
+    Entry &entry = m_entries[k];
+    // a pending reply will be at least as recent
+    if (entry.watcher)
+        return;
+    entry.properties = properties;
+    entry.stale = false;
+}
+
+void OfonoPropertyCache::forget(const QString &path)
+{
+    QString self = path + '\n';
+    QString below = path + '/';
+    QHash<QString, Entry>::iterator i = m_entries.begin();
+    while (i != m_entries.end()) {
+        if (i.key().startsWith(self) || i.key().startsWith(below)) {
+            if (i.value().watcher) {
+                m_watchers.remove(i.value().watcher);
+                delete i.value().watcher;
+                if (!i.value().warmup.isEmpty())
+                    fetchDone(i.value().warmup);
+            }
+            entryRemoved(i.key());
+            i = m_entries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+
+    if (m_reconciling.isEmpty())
+        return;
+    QHash<QDBusPendingCallWatcher*, QString>::iterator j = m_reconciling.begin();
+    while (j != m_reconciling.end()) {
+        if (j.value().startsWith(self) || j.value().startsWith(below)) {
+            delete j.key();
+            j = m_reconciling.erase(j);
+        } else {
+            ++j;
+        }
+    }
+    if (m_reconciling.isEmpty())
+        emit reconcileFinished();
+}
+
+void OfonoPropertyCache::entryAdded(const QString &k)
+{
+    // changes are only listened to on the objects that have entries, so
+    // that the process is not woken up by every change of every modem
+    QString path = k.left(k.indexOf('\n'));
+    if (m_watched[path]++ == 0)
+        m_connection.bus().connect(m_connection.service(), path, QString(),
+                                   "PropertyChanged",
+                                   this,
+                                   SLOT(onPropertyChanged(QString, QDBusVariant)));
+}
+
+void OfonoPropertyCache::entryRemoved(const QString &k)
+{
+    QString path = k.left(k.indexOf('\n'));
+    QHash<QString, int>::iterator i = m_watched.find(path);
+    if (i == m_watched.end() || --i.value() > 0)
+        return;
+    m_watched.erase(i);
+    unwatch(path);
+}
+
+void OfonoPropertyCache::unwatch(const QString &path)
+{
+    m_connection.bus().disconnect(m_connection.service(), path, QString(),
+                                  "PropertyChanged",
+                                  this,
+                                  SLOT(onPropertyChanged(QString, QDBusVariant)));
+}
+
+void OfonoPropertyCache::onPropertyChanged(QString property, QDBusVariant value)
+{
+    QString path = message().path();
+    QString ifname = message().interface();
+    QHash<QString, Entry>::iterator i = m_entries.find(key(path, ifname));
+    // the GetProperties reply of a pending entry was sent after this change
+    if (i == m_entries.end() || i.value().watcher)
+        return;
+    i.value().properties[property] = value.variant();
+
+    if (ifname == "org.ofono.Modem" && property == "Interfaces") {
+        QStringList interfaces = value.variant().toStringList();
+        QString prefix = path + '\n';
+        QHash<QString, Entry>::iterator j = m_entries.begin();
+        while (j != m_entries.end()) {
+            if (j.key().startsWith(prefix) && !j.value().watcher
+                && !interfaces.contains(j.key().mid(prefix.length()))
+                && j.key() != key(path, "org.ofono.Modem")) {
+                entryRemoved(j.key());
+                j = m_entries.erase(j);
+            } else {
+                ++j;
+            }
+        }
+    }
+}
+
+void OfonoPropertyCache::onServiceLost()
+{
+    foreach (QDBusPendingCallWatcher *watcher, m_watchers.keys())
+        delete watcher;
+    m_watchers.clear();
+    m_entries.clear();
+    foreach (QString path, m_watched.keys())
+        unwatch(path);
+    m_watched.clear();
+    m_warming.clear();
+
+    if (m_reconciling.isEmpty())
+        return;
+    foreach (QDBusPendingCallWatcher *watcher, m_reconciling.keys())
+        delete watcher;
+    m_reconciling.clear();
+    emit reconcileFinished();
+}
+
+static bool isPersistable(const QVariant &value)
+{
+    // D-Bus types such as QDBusArgument cannot be streamed
+    switch (value.userType()) {
+    case QMetaType::QVariantList:
+        foreach (const QVariant &item, value.toList()) {
+            if (!isPersistable(item))
+                return false;
+        }
+        return true;
+    case QMetaType::QVariantMap:
+        foreach (const QVariant &item, value.toMap()) {
+            if (!isPersistable(item))
+                return false;
+        }
+        return true;
+    default:
+        return value.userType() < QMetaType::User;
+    }
+}
+
+bool OfonoPropertyCache::save(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << (quint32)CACHE_FILE_MAGIC << (quint16)CACHE_FILE_VERSION;
+
+    QStringList keys;
+    for (QHash<QString, Entry>::const_iterator i = m_entries.begin(); i != m_entries.end(); ++i) {
+        if (!i.value().watcher)
+            keys << i.key();
+    }
+    out << (quint32)keys.count();
+    foreach (QString k, keys) {
+        const QVariantMap &all = m_entries[k].properties;
+        QVariantMap properties;
+        for (QVariantMap::const_iterator i = all.begin(); i != all.end(); ++i) {
+            if (isPersistable(i.value()))
+                properties.insert(i.key(), i.value());
+        }
+        out << k << properties;
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool OfonoPropertyCache::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    quint16 version;
+    quint32 count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION)
+        return false;
+
+    // a truncated file is rejected as a whole
+    QList<QPair<QString, QVariantMap> > loaded;
+    for (quint32 n = 0; n < count; n++) {
+        QString k;
+        QVariantMap properties;
+        in >> k >> properties;
+        if (in.status() != QDataStream::Ok || k.indexOf('\n') < 0)
+            return false;
+        loaded << qMakePair(k, properties);
+    }
+
+    for (int n = 0; n < loaded.count(); n++) {
+        if (m_entries.contains(loaded[n].first))
+            continue;
+        Entry entry;
+        entry.properties = loaded[n].second;
+        entry.stale = true;
+        m_entries.insert(loaded[n].first, entry);
+        entryAdded(loaded[n].first);
+        startReconcile(loaded[n].first);
+    }
+    return true;
+}
+
+void OfonoPropertyCache::startReconcile(const QString &k)
+{
+    int sep = k.indexOf('\n');
+    QDBusMessage request = QDBusMessage::createMethodCall(m_connection.service(),
+                                                          k.left(sep), k.mid(sep + 1),
+                                                          "GetProperties");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.bus().asyncCall(request, GET_PROPERTIES_TIMEOUT), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(reconcileReplied(QDBusPendingCallWatcher*)));
+    m_reconciling.insert(watcher, k);
+}
+
+void OfonoPropertyCache::reconcileReplied(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    watcher->deleteLater();
+    QString k = m_reconciling.take(watcher);
+    int sep = k.indexOf('\n');
+
+    // an entry that was seeded meanwhile is fresh already
+    QVariantMap changed;
+    QHash<QString, Entry>::iterator i = m_entries.find(k);
+    if (i != m_entries.end() && i.value().stale) {
+        if (reply.isError()) {
+            m_entries.erase(i);
+            entryRemoved(k);
+        } else {
+            QVariantMap properties = reply.value();
+            for (QVariantMap::const_iterator j = properties.begin(); j != properties.end(); ++j) {
+                if (!i.value().properties.contains(j.key()) || i.value().properties[j.key()] != j.value())
+                    changed.insert(j.key(), j.value());
+            }
+            i.value().properties = properties;
+            i.value().stale = false;
+        }
+    }
+    emit reconciled(k.left(sep), k.mid(sep + 1), changed);
+    if (m_reconciling.isEmpty())
+        emit reconcileFinished();
+}
+
+bool OfonoPropertyCache::isStale(const QString &path, const QString &ifname) const
+{
+    QHash<QString, Entry>::const_iterator i = m_entries.find(key(path, ifname));
+    return i != m_entries.end() && i.value().stale;
+}
+
+void OfonoPropertyCache::setAutoSave(const QString &fileName, int msecs)
+{
+    static bool registered = false;
+    if (!registered) {
+        qAddPostRoutine(saveAll);
+        registered = true;
+    }
+    if (!m_saveTimer) {
+        m_saveTimer = new QTimer(this);
+        connect(m_saveTimer, SIGNAL(timeout()), this, SLOT(autoSave()));
+    }
+
+    m_saveFile = fileName;
+    if (fileName.isEmpty() || msecs <= 0)
+        m_saveTimer->stop();
+    else
+        m_saveTimer->start(msecs);
+}
+
+void OfonoPropertyCache::autoSave()
+{
+    if (!m_saveFile.isEmpty())
+        save(m_saveFile);
+}
+
+void OfonoPropertyCache::saveAll()
+{
+    foreach (OfonoPropertyCache *cache, caches)
+        cache->autoSave();
+}
@@ -0,0 +1,183 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOPROPERTYCACHE_H
+#define OFONOPROPERTYCACHE_H
+
+#include <QtCore/QObject>
+#include <QHash>
+#include <QVariant>
+#include <QDBusVariant>
+#include <QDBusContext>
+#include "ofonoconnection.h"
+#include "libofono-qt_global.h"
+
+class QDBusPendingCallWatcher;
+class QTimer;
+
+//! Shared cache of the properties of modem-level oFono interfaces
+/*!
+ * Every library object fetches the properties of its interface when it is
+ * constructed, with a blocking GetProperties call, so building all interface
+ * objects of a modem takes one round trip per interface. warmUp() instead
+ * issues GetProperties for all interfaces of a modem at once; objects that
+ * are constructed afterwards, or while the calls are still in flight, take
+ * their properties from the cache.
+ *
+ * The modem properties are also taken from the GetModems reply and the
+ * ModemAdded signal, so OfonoModem needs no GetProperties call of its own,
+ * and the context properties from the GetContexts reply and the ContextAdded
+ * signal.
+ *
+ * The cache is kept up to date with PropertyChanged signals, listening only
+ * to the objects it has entries for; entries of an interface are dropped
+ * when it disappears from the modem, and the whole cache is dropped when
+ * oFono goes away. There is one cache per connection; it must be used from
+ * the main thread.
+ *
+ * The cache can be written to a file with save() or setAutoSave(), and read
+ * back with load() when the application starts again, before any library
+ * objects are constructed. Loaded entries are served immediately but are
+ * marked as stale, and they are reconciled with oFono in the background;
+ * objects built from stale entries issue propertyChanged() for every value
+ * that turns out to be different. Only values of built-in types are saved,
+ * so properties such as the context settings are missing from stale entries
+ * until they have been reconciled.
+ */
+class OFONO_QT_EXPORT OfonoPropertyCache : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+
+public:
+    //! Returns the cache of a connection
+    static OfonoPropertyCache *forConnection(const OfonoConnection &connection);
+
+    //! Fetches the properties of all interfaces of a modem concurrently
+    /*!
+     * The modem properties are fetched first if they are not cached yet.
+     * warmedUp() is issued when all calls have completed.
+     */
+    void warmUp(const QString &modemPath);
+
+    //! Returns true while a warm-up of a modem is in progress
+    bool isWarmingUp(const QString &modemPath) const {return m_warming.contains(modemPath);}
+
+    //! Returns true if the properties of an interface are cached
+    bool contains(const QString &path, const QString &ifname) const;
+
+    //! Returns the properties of an interface, waiting for them if they are being fetched
+    /*!
+     * Returns false if the properties are neither cached nor being fetched,
+     * or if fetching them has failed. Stale entries are returned without
+     * waiting for them to be reconciled; \a stale is set accordingly.
+     */
+    bool fetch(const QString &path, const QString &ifname, QVariantMap &properties, bool *stale=0);
+
+    //! Stores the properties of an interface obtained elsewhere
+    void seed(const QString &path, const QString &ifname, const QVariantMap &properties);
+
+    //! Drops all entries of an object path and the paths below it
+    void forget(const QString &path);
+
+    //! Writes all cached properties to a file
+    /*!
+     * The file is replaced atomically. Returns false if it could not be written.
+     */
+    bool save(const QString &fileName) const;
+
+    //! Reads properties written with save() and starts reconciling them
+    /*!
+     * Entries that are already cached are kept. Returns false if the file
+     * could not be read or is not a cache file.
+     */
+    bool load(const QString &fileName);
+
+    //! Saves the cache to a file every \a msecs milliseconds and at exit
+    /*!
+     * A non-positive interval only saves at exit; an empty file name
+     * disables saving.
+     */
+    void setAutoSave(const QString &fileName, int msecs=0);
+
+    //! Returns true if the properties of an interface were loaded and have not been reconciled yet
+    bool isStale(const QString &path, const QString &ifname) const;
+
+    //! Returns true while loaded entries are being reconciled
+    bool isReconciling() const {return !m_reconciling.isEmpty();}
+
+Q_SIGNALS:
+    //! Issued when a warm-up started with warmUp() has completed
+    void warmedUp(const QString &modemPath);
+
+    //! Issued when a stale entry has been reconciled
+    /*!
+     * \param changed properties that were added or have changed; empty as
+     * well if the interface no longer exists, see contains()
+     */
+    void reconciled(const QString &path, const QString &ifname, const QVariantMap &changed);
+
+    //! Issued when all loaded entries have been reconciled
+    void reconcileFinished();
+
+private Q_SLOTS:
+    void onPropertyChanged(QString property, QDBusVariant value);
+    void fetchFinished(QDBusPendingCallWatcher *watcher);
+    void onServiceLost();
+    void reconcileReplied(QDBusPendingCallWatcher *watcher);
+    void autoSave();
+
+private:
+    struct Entry {
+        Entry() : watcher(0), stale(false) {}
+        QVariantMap properties;
+        QDBusPendingCallWatcher *watcher;
+        QString warmup;
+        bool stale;
+    };
+
+    explicit OfonoPropertyCache(const OfonoConnection &connection);
+    ~OfonoPropertyCache();
+
+    static QString key(const QString &path, const QString &ifname) {return path + '\n' + ifname;}
+    void startFetch(const QString &path, const QString &ifname, const QString &warmup);
+    void handleReply(const QString &key, QDBusPendingCallWatcher *watcher);
+    void fetchInterfaces(const QString &modemPath);
+    void fetchDone(const QString &warmup);
+    void startReconcile(const QString &k);
+    void entryAdded(const QString &k);
+    void entryRemoved(const QString &k);
+    void unwatch(const QString &path);
+    static void saveAll();
+
+private:
+    OfonoConnection m_connection;
+    QHash<QString, Entry> m_entries;
+    QHash<QString, int> m_watched;
+    QHash<QDBusPendingCallWatcher*, QString> m_watchers;
+    QHash<QString, int> m_warming;
+    QHash<QDBusPendingCallWatcher*, QString> m_reconciling;
+    QString m_saveFile;
+    QTimer *m_saveTimer;
+};
+
+#endif
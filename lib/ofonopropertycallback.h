@@ -0,0 +1,38 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOPROPERTYCALLBACK_H
+#define OFONOPROPERTYCALLBACK_H
+
+#include <functional>
+#include <QVariant>
+
+//! Callback invoked with the new value of a property
+/*!
+ * Property callbacks are called directly from the code that processes the
+ * property update, without going through the Qt signal and slot machinery.
+ * They are called in the thread of the object they were registered on.
+ */
+typedef std::function<void(const QVariant &value)> OfonoPropertyCallback;
+
+#endif
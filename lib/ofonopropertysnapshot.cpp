@@ -0,0 +1,59 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "ofonopropertysnapshot.h"
+#include "ofonointerface_p.h"
+
+OfonoPropertySnapshot::OfonoPropertySnapshot()
+{
+}
+
+OfonoPropertySnapshot::OfonoPropertySnapshot(const std::shared_ptr<const OfonoPropertySnapshotData> &data)
+    : d(data)
+{
+}
+
+quint64 OfonoPropertySnapshot::version() const
+{
+    return d ? d->version : 0;
+}
+
+QString OfonoPropertySnapshot::path() const
+{
+    return d ? d->path : QString();
+}
+
+QVariantMap OfonoPropertySnapshot::properties() const
+{
+    return d ? d->properties : QVariantMap();
+}
+
+bool OfonoPropertySnapshot::contains(const QString &name) const
+{
+    return d && d->properties.contains(name);
+}
+
+QVariant OfonoPropertySnapshot::value(const QString &name, const QVariant &defaultValue) const
+{
+    return d ? d->properties.value(name, defaultValue) : defaultValue;
+}
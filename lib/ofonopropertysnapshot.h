@@ -0,0 +1,71 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOPROPERTYSNAPSHOT_H
+#define OFONOPROPERTYSNAPSHOT_H
+
+#include <memory>
+#include <QVariant>
+#include "libofono-qt_global.h"
+
+struct OfonoPropertySnapshotData;
+
+//! An immutable view of all properties of an oFono interface
+/*!
+ * A snapshot holds the properties of an interface exactly as they were
+ * after one update; later updates publish a new snapshot and never modify
+ * existing ones, so the values read from one snapshot are always consistent
+ * with each other. Snapshots are implicitly shared, cheap to copy and may be
+ * read from any thread.
+ *
+ * The version increases with every update, so a consumer can skip work
+ * when the version it last saw is still current.
+ */
+class OFONO_QT_EXPORT OfonoPropertySnapshot
+{
+public:
+    //! Constructs a null snapshot
+    OfonoPropertySnapshot();
+
+    bool isNull() const {return !d;}
+
+    //! Returns the update counter of the interface, or 0 for a null snapshot
+    quint64 version() const;
+
+    //! Returns the D-Bus path the properties belong to
+    QString path() const;
+
+    //! Returns all properties
+    QVariantMap properties() const;
+
+    bool contains(const QString &name) const;
+    QVariant value(const QString &name, const QVariant &defaultValue = QVariant()) const;
+
+private:
+    friend class OfonoInterface;
+    explicit OfonoPropertySnapshot(const std::shared_ptr<const OfonoPropertySnapshotData> &data);
+
+    std::shared_ptr<const OfonoPropertySnapshotData> d;
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include "ofonopropertytrigger.h"
+
+OfonoPropertyTrigger::OfonoPropertyTrigger()
+    : m_condition(Changes), m_hysteresis(0), m_level(Unknown), m_primed(false)
+{
+}
+
+OfonoPropertyTrigger::OfonoPropertyTrigger(const QString &name, Condition condition,
+                                           const QVariant &reference, double hysteresis)
+    : m_name(name), m_condition(condition), m_reference(reference),
+      m_hysteresis(hysteresis < 0 ? -hysteresis : hysteresis),
+      m_level(Unknown), m_primed(false)
+{
+}
+
+void OfonoPropertyTrigger::reset()
+{
+    m_last = QVariant();
+    m_level = Unknown;
+    m_primed = false;
+}
+
+OfonoPropertyTrigger::Level OfonoPropertyTrigger::levelOf(const QVariant &value) const
+{
+    double threshold = m_reference.toDouble();
+    double sample = value.toDouble();
+
+    if (sample >= threshold)
+        return High;
+    if (sample <= threshold - m_hysteresis)
+        return Low;
+    // inside the hysteresis band the previous state holds
+    return m_level == Unknown ? Low : m_level;
+}
+
+bool OfonoPropertyTrigger::update(const QVariant &value)
+{
+    bool fired = false;
+
+    switch (m_condition) {
+    case Rises:
+    case Falls:
+    case Crosses: {
+        Level level = levelOf(value);
+        if (m_primed && level != m_level) {
+            if (m_condition == Crosses)
+                fired = true;
+            else if (m_condition == Rises)
+                fired = (level == High);
+            else
+                fired = (level == Low);
+        }
+        m_level = level;
+        break;
+    }
+    case Enters:
+        fired = m_primed && m_last != m_reference && value == m_reference;
+        break;
+    case Leaves:
+        fired = m_primed && m_last == m_reference && value != m_reference;
+        break;
+    case Changes:
+        fired = m_primed && m_last != value;
+        break;
+    }
+
+    m_last = value;
+    m_primed = true;
+    return fired;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOPROPERTYTRIGGER_H
+#define OFONOPROPERTYTRIGGER_H
+
+#include <QString>
+#include <QVariant>
+#include "libofono-qt_global.h"
+
+//! Describes a transition of an oFono property that should be reported
+/*!
+ * A trigger is fed with every value a property takes and reports only the
+ * samples which complete the transition described by its condition. The first
+ * sample only establishes the starting state and is never reported.
+ *
+ * Numeric conditions use a hysteresis band below the threshold: the value is
+ * considered high once it reaches the threshold and low once it drops to
+ * (threshold - hysteresis) or below. Values within the band keep the previous
+ * state, so a signal strength wobbling around the threshold is reported once.
+ */
+class OFONO_QT_EXPORT OfonoPropertyTrigger
+{
+public:
+    //! Transition that the trigger reports
+    enum Condition {
+        Rises,      /*!< Numeric value goes from low to high */
+        Falls,      /*!< Numeric value goes from high to low */
+        Crosses,    /*!< Numeric value goes from low to high or from high to low */
+        Enters,     /*!< Value becomes equal to the reference value */
+        Leaves,     /*!< Value stops being equal to the reference value */
+        Changes     /*!< Value differs from the previous sample */
+    };
+
+    OfonoPropertyTrigger();
+
+    /*!
+     * \param name name of the oFono property
+     * \param condition transition to report
+     * \param reference threshold for numeric conditions, value for Enters and Leaves;
+     * ignored for Changes
+     * \param hysteresis width of the band below the threshold for numeric conditions
+     */
+    OfonoPropertyTrigger(const QString &name, Condition condition,
+                         const QVariant &reference = QVariant(), double hysteresis = 0);
+
+    QString name() const {return m_name;}
+    Condition condition() const {return m_condition;}
+    QVariant reference() const {return m_reference;}
+    double hysteresis() const {return m_hysteresis;}
+
+    //! Feeds a new sample to the trigger
+    /*!
+     * Returns true if the sample completes the transition described by the
+     * condition.
+     */
+    bool update(const QVariant &value);
+
+    //! Forgets the state established by the previous samples
+    void reset();
+
+private:
+    enum Level {
+        Unknown,
+        Low,
+        High
+    };
+
+    Level levelOf(const QVariant &value) const;
+
+    QString m_name;
+    Condition m_condition;
+    QVariant m_reference;
+    double m_hysteresis;
+    QVariant m_last;
+    Level m_level;
+    bool m_primed;
+};
+
+#endif
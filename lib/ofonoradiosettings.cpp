@@ -29,6 +29,17 @@
 
 OfonoRadioSettings::OfonoRadioSettings(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.RadioSettings", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoRadioSettings::OfonoRadioSettings(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.RadioSettings", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoRadioSettings::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -44,6 +44,8 @@ class OFONO_QT_EXPORT OfonoRadioSettings : public OfonoModemInterface
 
 public:
     OfonoRadioSettings(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoRadioSettings(OfonoModem *modem, QObject *parent=0);
     ~OfonoRadioSettings();
 
     QString technologyPreference() const;
@@ -69,6 +71,9 @@ Q_SIGNALS:
 private Q_SLOTS:
     void propertyChanged(const QString& property, const QVariant& value);
     void setPropertyFailed(const QString& property);    
+
+private:
+    void init();
 };
 
 
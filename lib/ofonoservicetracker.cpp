@@ -0,0 +1,110 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtDBus/QtDBus>
+#include <QtCore/QObject>
+
+#include "ofonoservicetracker.h"
+
+static QHash<QString, OfonoServiceTracker*> trackers;
+
+OfonoServiceTracker *OfonoServiceTracker::forConnection(const OfonoConnection &connection)
+{
+    QString key = connection.bus().name() + '\n' + connection.service();
+    OfonoServiceTracker *tracker = trackers.value(key);
+    if (!tracker) {
+        tracker = new OfonoServiceTracker(connection);
+        trackers.insert(key, tracker);
+    }
+    return tracker;
+}
+
+OfonoServiceTracker::OfonoServiceTracker(const OfonoConnection &connection)
+    : QObject(0), m_connection(connection), m_pending(0)
+{
+    m_watcher = new QDBusServiceWatcher(connection.service(), connection.bus(),
+                                        QDBusServiceWatcher::WatchForOwnerChange, this);
+    connect(m_watcher, SIGNAL(serviceOwnerChanged(const QString&, const QString&, const QString&)),
+            this, SLOT(onServiceOwnerChanged(const QString&, const QString&, const QString&)));
+
+    // peer-to-peer connections have no bus daemon to ask
+    QDBusConnectionInterface *daemon = connection.bus().interface();
+    m_available = daemon ? daemon->isServiceRegistered(connection.service()).value()
+                         : connection.bus().isConnected();
+}
+
+OfonoServiceTracker::~OfonoServiceTracker()
+{
+}
+
+void OfonoServiceTracker::onServiceOwnerChanged(const QString& /*service*/,
+                                                const QString& oldOwner, const QString& newOwner)
+{
+    // a restarted daemon may take over the name without a gap
+    if (!oldOwner.isEmpty())
+        setAvailable(false);
+    if (!newOwner.isEmpty())
+        setAvailable(true);
+}
+
+void OfonoServiceTracker::setAvailable(bool available)
+{
+    if (m_available == available)
+        return;
+    m_available = available;
+    // fetches of an earlier return no longer count
+    m_fetches.clear();
+    m_pending = 0;
+
+    if (!available) {
+        emit serviceLost();
+        return;
+    }
+
+    // objects register their fetches while handling serviceReturned(); the
+    // extra count keeps resynced() from being issued before they all have
+    m_pending = 1;
+    emit serviceReturned();
+    endFetch();
+}
+
+void OfonoServiceTracker::addFetch(QDBusPendingCallWatcher *watcher)
+{
+    if (m_pending == 0)
+        return;
+    m_pending++;
+    m_fetches.insert(watcher);
+    connect(watcher, SIGNAL(destroyed(QObject*)), this, SLOT(fetchDestroyed(QObject*)));
+}
+
+void OfonoServiceTracker::fetchDestroyed(QObject *watcher)
+{
+    if (m_fetches.remove(watcher))
+        endFetch();
+}
+
+void OfonoServiceTracker::endFetch()
+{
+    if (m_pending > 0 && --m_pending == 0)
+        emit resynced();
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOSERVICETRACKER_H
+#define OFONOSERVICETRACKER_H
+
+#include <QtCore/QObject>
+#include <QSet>
+#include "ofonoconnection.h"
+#include "libofono-qt_global.h"
+
+class QDBusServiceWatcher;
+class QDBusPendingCallWatcher;
+
+//! Tracks the owner of the oFono service of a connection
+/*!
+ * When oFono goes away, every library object using the connection drops
+ * its cached state: modem, call, message and context lists are emptied
+ * with the usual removal signals, and property caches are cleared. When
+ * oFono comes back, the objects fetch their state again with asynchronous
+ * calls issued all at once, and report it with the usual signals. The
+ * tracker issues resynced() once all of them have completed.
+ *
+ * There is one tracker per connection; it must be used from the main thread.
+ */
+class OFONO_QT_EXPORT OfonoServiceTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Returns the tracker of a connection
+    static OfonoServiceTracker *forConnection(const OfonoConnection &connection);
+
+    OfonoConnection connection() const {return m_connection;}
+
+    //! Returns true if the oFono service currently has an owner
+    bool isServiceAvailable() const {return m_available;}
+
+    //! Returns true while objects are fetching their state after the service has returned
+    bool isResyncing() const {return m_pending > 0;}
+
+    //! Registers a state fetch started by a library object in response to serviceReturned()
+    /*!
+     * The fetch counts as completed when \a watcher is destroyed, so the
+     * object deletes the watcher once it has handled the reply, or to abandon
+     * the fetch.
+     */
+    void addFetch(QDBusPendingCallWatcher *watcher);
+
+Q_SIGNALS:
+    //! Issued when the oFono service has lost its owner
+    void serviceLost();
+
+    //! Issued when the oFono service has a new owner
+    void serviceReturned();
+
+    //! Issued when every object has fetched its state after the service has returned
+    void resynced();
+
+private Q_SLOTS:
+    void onServiceOwnerChanged(const QString &service, const QString &oldOwner, const QString &newOwner);
+    void fetchDestroyed(QObject *watcher);
+
+private:
+    explicit OfonoServiceTracker(const OfonoConnection &connection);
+    ~OfonoServiceTracker();
+
+    void setAvailable(bool available);
+    void endFetch();
+
+private:
+    OfonoConnection m_connection;
+    QDBusServiceWatcher *m_watcher;
+    bool m_available;
+    int m_pending;
+    QSet<QObject*> m_fetches;
+};
+
+#endif
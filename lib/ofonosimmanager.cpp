@@ -29,6 +29,17 @@
 
 OfonoSimManager::OfonoSimManager(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.SimManager", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoSimManager::OfonoSimManager(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.SimManager", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoSimManager::init()
 {
     qRegisterMetaType<OfonoServiceNumbers>("OfonoServiceNumbers");
     qRegisterMetaType<OfonoPinRetries>("OfonoPinRetries");
@@ -36,7 +47,6 @@ OfonoSimManager::OfonoSimManager(OfonoModem::SelectionSetting modemSetting, cons
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
     connect(m_if, SIGNAL(setPropertyFailed(const QString&)), 
             this, SLOT(setPropertyFailed(const QString&)));
-
 }
 
 OfonoSimManager::~OfonoSimManager()
@@ -47,12 +57,12 @@ void OfonoSimManager::changePin(const QString &pintype, const QString &oldpin, c
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "ChangePin");
     request << pintype << oldpin << newpin;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(changePinResp()),
 					SLOT(changePinErr(const QDBusError&)));
 }
@@ -61,12 +71,12 @@ void OfonoSimManager::enterPin(const QString &pintype, const QString &pin)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "EnterPin");
     request << pintype << pin;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(enterPinResp()),
 					SLOT(enterPinErr(const QDBusError&)));
 }
@@ -75,12 +85,12 @@ void OfonoSimManager::resetPin(const QString &pintype, const QString &puk, const
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "ResetPin");
     request << pintype << puk << newpin;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(resetPinResp()),
 					SLOT(resetPinErr(const QDBusError&)));
 }
@@ -89,12 +99,12 @@ void OfonoSimManager::lockPin(const QString &pintype, const QString &pin)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "LockPin");
     request << pintype << pin;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(lockPinResp()),
 					SLOT(lockPinErr(const QDBusError&)));
 }
@@ -103,12 +113,12 @@ void OfonoSimManager::unlockPin(const QString &pintype, const QString &pin)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "UnlockPin");
     request << pintype << pin;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(unlockPinResp()),
 					SLOT(unlockPinErr(const QDBusError&)));
 }
@@ -117,12 +127,12 @@ void OfonoSimManager::getIcon(quint8 id)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "GetIcon");
     request << QVariant::fromValue(id);
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(getIconResp(QByteArray)),
 					SLOT(getIconErr(const QDBusError&)));
 }
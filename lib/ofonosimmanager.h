@@ -60,6 +60,8 @@ class OFONO_QT_EXPORT OfonoSimManager : public OfonoModemInterface
 
 public:
     OfonoSimManager(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoSimManager(OfonoModem *modem, QObject *parent=0);
     ~OfonoSimManager();
 
     /* Properties */
@@ -128,6 +130,7 @@ private Q_SLOTS:
     void getIconErr(QDBusError error);
 
 private:
+    void init();
 
 };
 
@@ -31,6 +31,17 @@
 
 OfonoSupplementaryServices::OfonoSupplementaryServices(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.SupplementaryServices", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoSupplementaryServices::OfonoSupplementaryServices(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.SupplementaryServices", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoSupplementaryServices::init()
 {
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -46,19 +57,19 @@ void OfonoSupplementaryServices::pathChanged(const QString& path)
 
 void OfonoSupplementaryServices::connectDbusSignals(const QString& path)
 {
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(), 
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(), 
 					     "NotificationReceived",
 					     this,
 					     SIGNAL(notificationReceived(QString)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(), 
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(), 
 					     "RequestReceived",
 					     this,
 					     SIGNAL(requestReceived(QString)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(), 
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(), 
 					     "NotificationReceived",
 					     this,
 					     SIGNAL(notificationReceived(QString)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(), 
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(), 
 					     "RequestReceived",
 					     this,
 					     SIGNAL(requestReceived(QString)));
@@ -72,12 +83,12 @@ void OfonoSupplementaryServices::initiate(const QString &command)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Initiate");
     request << command;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(initiateResp(QString, QDBusVariant)),
 					SLOT(initiateErr(const QDBusError&)),
 					REQUEST_TIMEOUT);
@@ -87,12 +98,12 @@ void OfonoSupplementaryServices::respond(const QString &reply)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Respond");
     request << reply;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(respondResp(QString)),
 					SLOT(respondErr(const QDBusError&)),
 					REQUEST_TIMEOUT);
@@ -102,11 +113,11 @@ void OfonoSupplementaryServices::cancel()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
 					     path(), m_if->ifname(),
 					     "Cancel");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
 					SLOT(cancelResp()),
 					SLOT(cancelErr(const QDBusError&)),
 					REQUEST_TIMEOUT);
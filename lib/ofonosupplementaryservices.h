@@ -43,6 +43,8 @@ class OFONO_QT_EXPORT OfonoSupplementaryServices : public OfonoModemInterface
     Q_PROPERTY(QString state READ state)
 public:
     OfonoSupplementaryServices(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoSupplementaryServices(OfonoModem *modem, QObject *parent=0);
     ~OfonoSupplementaryServices();
     
     /* Properties */
@@ -81,6 +83,7 @@ private Q_SLOTS:
     void cancelResp();
     void cancelErr(QDBusError error);
 private:
+    void init();
     void connectDbusSignals(const QString& path);
 
 };
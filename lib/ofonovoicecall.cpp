@@ -26,37 +26,78 @@
 
 #include "ofonointerface.h"
 #include "ofonovoicecall.h"
+#include "ofonovoicecall_p.h"
 
 #define VOICECALL_TIMEOUT 30000
 
-OfonoVoiceCall::OfonoVoiceCall(const QString& callId, QObject *parent)
-    : QObject(parent)
+OfonoVoiceCallShared::OfonoVoiceCallShared(const QString &callId)
+    : QObject(0)
 {
     m_if = new OfonoInterface(callId, "org.ofono.VoiceCall", OfonoGetAllOnStartup, this);
 
+    // the state the call was in when it was first seen starts the timeline
+    QString state = m_if->properties()["State"].value<QString>();
+    if (!state.isEmpty())
+        m_timeline.record(state);
+
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
+    m_if->connection().bus().connect(m_if->connection().service(), callId, m_if->ifname(),
+                                     "DisconnectReason", this,
+                                     SLOT(disconnectReasonChanged(const QString&)));
+}
 
-    QDBusConnection::systemBus().connect("org.ofono",path(),m_if->ifname(),
-                                         "DisconnectReason", this,
-                                         SIGNAL(disconnectReason(const QString&)));
+void OfonoVoiceCallShared::propertyChanged(const QString &property, const QVariant &value)
+{
+    if (property == "State")
+        m_timeline.record(value.value<QString>());
+}
 
+void OfonoVoiceCallShared::disconnectReasonChanged(const QString &reason)
+{
+    m_timeline.recordDisconnectReason(reason);
+    emit disconnectReason(reason);
+}
+
+OfonoVoiceCall::OfonoVoiceCall(const QString& callId, QObject *parent)
+    : QObject(parent), m_if(0)
+{
+    // the last copy may go away from a slot connected to the shared state
+    attach(QSharedPointer<OfonoVoiceCallShared>(new OfonoVoiceCallShared(callId),
+                                                &QObject::deleteLater));
 }
 
 OfonoVoiceCall::OfonoVoiceCall(const OfonoVoiceCall& call)
-    : QObject(call.parent())
+    : QObject(call.parent()), m_if(0)
+{
+    attach(call.m_shared);
+}
+
+OfonoVoiceCall::OfonoVoiceCall(OfonoVoiceCall &&call)
+    : QObject(call.parent()), m_if(0)
 {
-    m_if = new OfonoInterface(call.path(), "org.ofono.VoiceCall", OfonoGetAllOnStartup, this);
+    attach(call.detach());
+}
 
-    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
-            this, SLOT(propertyChanged(const QString&, const QVariant&)));
+OfonoVoiceCall &OfonoVoiceCall::operator=(const OfonoVoiceCall &call)
+{
+    if (m_shared != call.m_shared) {
+        detach();
+        attach(call.m_shared);
+    }
+    return *this;
+}
 
-    QDBusConnection::systemBus().connect("org.ofono",path(),m_if->ifname(),
-                                         "DisconnectReason", this,
-                                         SIGNAL(disconnectReason(const QString&)));
+OfonoVoiceCall &OfonoVoiceCall::operator=(OfonoVoiceCall &&call)
+{
+    if (this != &call) {
+        detach();
+        attach(call.detach());
+    }
+    return *this;
 }
 
-bool OfonoVoiceCall::operator==(const OfonoVoiceCall &call)
+bool OfonoVoiceCall::operator==(const OfonoVoiceCall &call) const
 {
     return path() == call.path();
 }
@@ -65,15 +106,40 @@ OfonoVoiceCall::~OfonoVoiceCall()
 {
 }
 
+void OfonoVoiceCall::attach(const QSharedPointer<OfonoVoiceCallShared> &shared)
+{
+    m_shared = shared;
+    if (!m_shared)
+        return;
+    m_if = m_shared->interface();
+
+    connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)),
+            this, SLOT(propertyChanged(const QString&, const QVariant&)));
+    connect(m_shared.data(), SIGNAL(disconnectReason(const QString&)),
+            this, SIGNAL(disconnectReason(const QString&)));
+}
+
+QSharedPointer<OfonoVoiceCallShared> OfonoVoiceCall::detach()
+{
+    QSharedPointer<OfonoVoiceCallShared> shared;
+    if (m_shared) {
+        disconnect(m_if, 0, this, 0);
+        disconnect(m_shared.data(), 0, this, 0);
+    }
+    shared.swap(m_shared);
+    m_if = 0;
+    return shared;
+}
+
 void OfonoVoiceCall::answer()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "Answer");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
                                         SLOT(answerResp()),
                                         SLOT(answerErr(const QDBusError&)),
                                         VOICECALL_TIMEOUT);
@@ -83,11 +149,11 @@ void OfonoVoiceCall::hangup()
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "Hangup");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
                                         SLOT(hangupResp()),
                                         SLOT(hangupErr(const QDBusError&)),
                                         VOICECALL_TIMEOUT);
@@ -97,14 +163,14 @@ void OfonoVoiceCall::deflect(const QString &number)
 {
     QDBusMessage request;
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "Deflect");
     QList<QVariant>arg;
     arg.append(QVariant(number));
     request.setArguments(arg);
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
+    m_if->connection().bus().callWithCallback(request, this,
                                         SLOT(deflectResp()),
                                         SLOT(deflectErr(const QDBusError&)),
                                         VOICECALL_TIMEOUT);
@@ -239,3 +305,23 @@ QString OfonoVoiceCall::errorMessage() const
 {
     return m_if->errorMessage();
 }
+
+int OfonoVoiceCall::addPropertyCallback(const QString& name, const OfonoPropertyCallback& callback)
+{
+    return m_if->addPropertyCallback(name, callback);
+}
+
+void OfonoVoiceCall::removePropertyCallback(int handle)
+{
+    m_if->removePropertyCallback(handle);
+}
+
+const OfonoCallTimeline &OfonoVoiceCall::timeline() const
+{
+    return m_shared->timeline();
+}
+
+OfonoPropertySnapshot OfonoVoiceCall::snapshot() const
+{
+    return m_if->snapshot();
+}
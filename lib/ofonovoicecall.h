@@ -27,15 +27,24 @@
 #include <QVariant>
 #include <QStringList>
 #include <QDBusError>
+#include <QSharedPointer>
 
+#include "ofonopropertycallback.h"
+#include "ofonopropertysnapshot.h"
+#include "ofonocalltimeline.h"
 #include "libofono-qt_global.h"
 
 class OfonoInterface;
+class OfonoVoiceCallShared;
 
 //! This class is used to access oFono voice call API
 /*!
  * The API is documented in
  * http://git.kernel.org/?p=network/ofono/ofono.git;a=blob;f=doc/voicecall-api.txt
+ *
+ * Copies are cheap: they share the property cache and the D-Bus
+ * subscriptions of the original, so copying does not talk to oFono. A
+ * moved-from object may only be assigned to or destroyed.
  */
 class OFONO_QT_EXPORT OfonoVoiceCall : public QObject
 {
@@ -58,10 +67,15 @@ class OFONO_QT_EXPORT OfonoVoiceCall : public QObject
 public:
     OfonoVoiceCall(const QString &callId, QObject *parent=0);
     OfonoVoiceCall(const OfonoVoiceCall &op);
+    OfonoVoiceCall(OfonoVoiceCall &&op);
     ~OfonoVoiceCall();
 
-    OfonoVoiceCall operator=(const OfonoVoiceCall &op);
-    bool operator==(const OfonoVoiceCall &op);
+    OfonoVoiceCall &operator=(const OfonoVoiceCall &op);
+    OfonoVoiceCall &operator=(OfonoVoiceCall &&op);
+    bool operator==(const OfonoVoiceCall &op) const;
+
+    //! Returns true if both objects share the same backing state
+    bool isSharedWith(const OfonoVoiceCall &op) const {return m_shared == op.m_shared;}
 
     //! Returns the D-Bus object path of the voice call object
     QString path() const;
@@ -92,6 +106,28 @@ public:
     bool remoteHeld() const;
     bool remoteMultiparty() const;
 
+    //! Registers a callback for changes of a voice call property
+    /*!
+     * Returns a handle that can be passed to removePropertyCallback().
+     */
+    int addPropertyCallback(const QString &name, const OfonoPropertyCallback &callback);
+
+    //! Unregisters a callback registered with addPropertyCallback()
+    void removePropertyCallback(int handle);
+
+    //! Returns an immutable snapshot of all call properties
+    /*!
+     * See OfonoInterface::snapshot().
+     */
+    OfonoPropertySnapshot snapshot() const;
+
+    //! Returns the state transitions of the call
+    /*!
+     * Recording starts with the state the call was in when it was first
+     * seen by any copy of this object.
+     */
+    const OfonoCallTimeline &timeline() const;
+
 public Q_SLOTS:
     void answer();
     void hangup();
@@ -124,6 +160,11 @@ private Q_SLOTS:
     void deflectErr(const QDBusError &error);
 
 private:
+    void attach(const QSharedPointer<OfonoVoiceCallShared> &shared);
+    QSharedPointer<OfonoVoiceCallShared> detach();
+
+private:
+    QSharedPointer<OfonoVoiceCallShared> m_shared;
     OfonoInterface *m_if;
 
 };
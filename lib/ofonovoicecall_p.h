@@ -0,0 +1,67 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#ifndef OFONOVOICECALL_P_H
+#define OFONOVOICECALL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the ofono-qt API. It may change from version
+// to version without notice, or even be removed.
+//
+
+#include <QtCore/QObject>
+
+#include "ofonointerface.h"
+#include "ofonocalltimeline.h"
+
+//! State shared by all copies of an OfonoVoiceCall
+/*!
+ * Holds the property cache, the call timeline and the single
+ * DisconnectReason subscription of a call; the copies only connect to its
+ * signals.
+ */
+class OfonoVoiceCallShared : public QObject
+{
+    Q_OBJECT
+public:
+    explicit OfonoVoiceCallShared(const QString &callId);
+
+    OfonoInterface *interface() const {return m_if;}
+    const OfonoCallTimeline &timeline() const {return m_timeline;}
+
+Q_SIGNALS:
+    void disconnectReason(const QString &reason);
+
+private Q_SLOTS:
+    void propertyChanged(const QString &property, const QVariant &value);
+    void disconnectReasonChanged(const QString &reason);
+
+private:
+    OfonoInterface *m_if;
+    OfonoCallTimeline m_timeline;
+};
+
+#endif // OFONOVOICECALL_P_H
@@ -26,12 +26,22 @@
 
 #include <QtDBus/QtDBus>
 #include <QtCore/QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSharedPointer>
 
 #include "ofonovoicecallmanager.h"
+#include "ofonovoicecall.h"
+#include "ofonocallscheduler.h"
 #include "ofonointerface.h"
+#include "ofonopropertycache.h"
+#include "ofonoeventbus.h"
+#include "ofonoservicetracker.h"
 
 #define DIAL_TIMEOUT 30000
 #define TONE_TIMEOUT 10000
+#define TONE_CHUNK_LENGTH 8
+#define TONE_PAUSE 2000
 #define TRANSFER_TIMEOUT 20000
 #define SWAP_TIMEOUT 20000
 #define HANGUP_TIMEOUT 30000
@@ -39,6 +49,28 @@
 #define PRIVATE_CHAT_TIMEOUT 30000
 #define CREATE_MULTIPARTY_TIMEOUT 30000
 
+// the chunks of a string sent with sendTones()
+struct ToneSequence {
+    int remaining;
+    bool done;
+};
+
+// reduces a dial string to the digits that select the called party
+static QString dialedDigits(const QString &number)
+{
+    QString digits;
+    digits.reserve(number.length());
+    foreach (QChar c, number) {
+        if (c == ',' || c == 'p' || c == 'P' || c == 'w' || c == 'W')
+            break;
+        if (c.isDigit() || c == '*' || c == '#')
+            digits.append(c);
+    }
+    if (digits.startsWith("*31#") || digits.startsWith("#31#"))
+        digits.remove(0, 4);
+    return digits;
+}
+
 QDBusArgument &operator<<(QDBusArgument &argument, const OfonoVoiceCallManagerStruct &call)
 {
     argument.beginStructure();
@@ -57,11 +89,35 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, OfonoVoiceCallMan
 
 OfonoVoiceCallManager::OfonoVoiceCallManager(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent)
     : OfonoModemInterface(modemSetting, modemPath, "org.ofono.VoiceCallManager", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+OfonoVoiceCallManager::OfonoVoiceCallManager(OfonoModem *modem, QObject *parent)
+    : OfonoModemInterface(modem, "org.ofono.VoiceCallManager", OfonoGetAllOnStartup, parent)
+{
+    init();
+}
+
+void OfonoVoiceCallManager::init()
 {
     qDBusRegisterMetaType<OfonoVoiceCallManagerStruct>();
     qDBusRegisterMetaType<OfonoVoiceCallManagerList>();
 
-    m_calllist = getCallList();
+    m_tonesTotal = 0;
+    m_tonesSent = 0;
+    m_toneInFlight = false;
+    m_toneGeneration = 0;
+    m_toneChunkLength = 0;
+    m_scheduler = new OfonoCallScheduler(this);
+    m_refreshWatcher = 0;
+    m_tonePause = new QTimer(this);
+    m_tonePause->setSingleShot(true);
+    connect(m_tonePause, SIGNAL(timeout()), this, SLOT(sendNextTones()));
+
+    m_calllist = OfonoPathSet(getCallList());
+    syncCallObjects();
+    setEmergencyNumbers(emergencyNumbers());
 
     connect(m_if, SIGNAL(propertyChanged(const QString&, const QVariant&)), 
             this, SLOT(propertyChanged(const QString&, const QVariant&)));
@@ -70,6 +126,10 @@ OfonoVoiceCallManager::OfonoVoiceCallManager(OfonoModem::SelectionSetting modemS
     connect(modem(), SIGNAL(pathChanged(QString)), this, SLOT(pathChanged(const QString&)));
 
     connectDbusSignals(path());
+
+    OfonoServiceTracker *tracker = OfonoServiceTracker::forConnection(m_if->connection());
+    connect(tracker, SIGNAL(serviceLost()), this, SLOT(onServiceLost()));
+    connect(tracker, SIGNAL(serviceReturned()), this, SLOT(onServiceReturned()));
 }
 
 OfonoVoiceCallManager::~OfonoVoiceCallManager()
@@ -77,9 +137,34 @@ OfonoVoiceCallManager::~OfonoVoiceCallManager()
 }
 
 
-void OfonoVoiceCallManager::validityChanged(bool /*validity*/)
+void OfonoVoiceCallManager::validityChanged(bool validity)
+{
+    // the calls of another modem are fetched without blocking; until the
+    // reply arrives the list and the call objects are left as they are
+    delete m_refreshWatcher;
+    m_refreshWatcher = 0;
+    if (!validity) {
+        m_calllist = OfonoPathSet();
+        syncCallObjects();
+        return;
+    }
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                          path(), m_if->ifname(),
+                                                          "GetCalls");
+    m_refreshWatcher = new QDBusPendingCallWatcher(m_if->connection().bus().asyncCall(request), this);
+    connect(m_refreshWatcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(refreshCallsFinished(QDBusPendingCallWatcher*)));
+}
+
+void OfonoVoiceCallManager::refreshCallsFinished(QDBusPendingCallWatcher *watcher)
 {
-    m_calllist = getCallList();
+    QDBusPendingReply<OfonoVoiceCallManagerList> reply = *watcher;
+    watcher->deleteLater();
+    m_refreshWatcher = 0;
+
+    m_calllist = OfonoPathSet(callPaths(reply.isError() ? OfonoVoiceCallManagerList() : reply.value()));
+    syncCallObjects();
 }
 
 void OfonoVoiceCallManager::pathChanged(const QString& path)
@@ -98,194 +183,433 @@ QStringList OfonoVoiceCallManager::getCallList()
     qDBusRegisterMetaType<OfonoVoiceCallManagerStruct>();
     qDBusRegisterMetaType<OfonoVoiceCallManagerList>();
 
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "GetCalls");
-    reply = QDBusConnection::systemBus().call(request);
+    reply = m_if->connection().bus().call(request);
 
     calls = reply;
+    return callPaths(calls);
+}
+
+QStringList OfonoVoiceCallManager::callPaths(const OfonoVoiceCallManagerList &calls)
+{
+    QStringList callList;
+    OfonoPropertyCache *cache = OfonoPropertyCache::forConnection(m_if->connection());
     foreach(OfonoVoiceCallManagerStruct call, calls) {
-        messageList<< call.path.path();
+        callList << call.path.path();
+        cache->seed(call.path.path(), "org.ofono.VoiceCall", call.properties);
     }
-    return messageList;
+    return callList;
+}
+
+void OfonoVoiceCallManager::addCallObject(const QString &path)
+{
+    if (m_calls.contains(path))
+        return;
+    // the properties have been seeded into the cache from the payload
+    OfonoConnectionScope scope(m_if->connection());
+    m_calls.insert(path, new OfonoVoiceCall(path, this));
+}
+
+void OfonoVoiceCallManager::removeCallObject(const QString &path)
+{
+    OfonoVoiceCall *call = m_calls.take(path);
+    if (call)
+        call->deleteLater();
+    OfonoPropertyCache::forConnection(m_if->connection())->forget(path);
+}
+
+void OfonoVoiceCallManager::syncCallObjects()
+{
+    foreach (QString call, m_calls.keys()) {
+        if (!m_calllist.contains(call))
+            removeCallObject(call);
+    }
+    foreach (QString call, m_calllist.toList())
+        addCallObject(call);
+}
+
+QList<OfonoVoiceCall*> OfonoVoiceCallManager::callObjects() const
+{
+    QList<OfonoVoiceCall*> calls;
+    foreach (QString call, m_calllist.toList()) {
+        if (m_calls.contains(call))
+            calls << m_calls[call];
+    }
+    return calls;
 }
 
 void OfonoVoiceCallManager::connectDbusSignals(const QString& path)
 {
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "CallAdded", this,
                                          SLOT(callAddedChanged(const QDBusObjectPath&, const QVariantMap&)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(),
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(),
                                          "CallRemoved", this,
                                          SLOT(callRemovedChanged(const QDBusObjectPath&)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(), 
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(), 
                                         "BarringActive", this,
                                         SIGNAL(barringActive(const QString&)));
-    QDBusConnection::systemBus().disconnect("org.ofono", QString(), m_if->ifname(), 
+    m_if->connection().bus().disconnect(m_if->connection().service(), QString(), m_if->ifname(), 
                                         "Forwarded", this,
                                         SIGNAL(forwarded(const QString&)));
 
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "CallAdded", this,
                                          SLOT(callAddedChanged(const QDBusObjectPath&, const QVariantMap&)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(),
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(),
                                          "CallRemoved", this,
                                          SLOT(callRemovedChanged(const QDBusObjectPath&)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(), 
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(), 
                                         "BarringActive", this,
                                         SIGNAL(barringActive(const QString&)));
-    QDBusConnection::systemBus().connect("org.ofono", path, m_if->ifname(), 
+    m_if->connection().bus().connect(m_if->connection().service(), path, m_if->ifname(), 
                                         "Forwarded", this,
                                         SIGNAL(forwarded(const QString&)));
 }
 
-QDBusObjectPath OfonoVoiceCallManager::dial(const QString &number, const QString &callerid_hide, bool &success)
+QDBusMessage OfonoVoiceCallManager::dialRequest(const QString &number, const QString &callerid_hide) const
 {
     QDBusMessage request;
-    QDBusReply<QDBusObjectPath> reply;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "Dial");
     QList<QVariant>arg;
     arg.append(QVariant(number));
     arg.append(QVariant(callerid_hide));
     request.setArguments(arg);
+    return request;
+}
 
-    reply = QDBusConnection::systemBus().call(request);
-    success = reply.isValid();
+OfonoCallScheduler::Lane OfonoVoiceCallManager::dialLane(const QString &number) const
+{
+    // an emergency call goes ahead of queued tones without dropping them
+    return isEmergencyNumber(number) ? OfonoCallScheduler::EmergencyLane
+                                     : OfonoCallScheduler::ControlLane;
+}
+
+QDBusObjectPath OfonoVoiceCallManager::dial(const QString &number, const QString &callerid_hide, bool &success)
+{
+    QDBusConnection bus = m_if->connection().bus();
+    QDBusMessage request = dialRequest(number, callerid_hide);
+    QDBusPendingReply<QDBusObjectPath> reply = m_scheduler->execute(dialLane(number), [bus, request]() {
+        return bus.asyncCall(request, DIAL_TIMEOUT);
+    });
+    success = !reply.isError();
     if (!success) {
         m_if->setError(reply.error().name(), reply.error().message());
+        return QDBusObjectPath();
     }
-    return reply;
+    return reply.value();
+}
+
+void OfonoVoiceCallManager::dialAsync(const QString &number, const QString &callerid_hide)
+{
+    m_scheduler->schedule(dialLane(number), m_if->connection().bus(), dialRequest(number, callerid_hide),
+                          DIAL_TIMEOUT, [this](const QDBusPendingCall &call) {
+        QDBusPendingReply<QDBusObjectPath> reply = call;
+        if (reply.isError())
+            dialErr(reply.error());
+        else
+            dialResp(reply.value());
+    });
 }
 
 void OfonoVoiceCallManager::hangupAll()
 {
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "HangupAll");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(hangupAllResp()),
-                                        SLOT(hangupAllErr(const QDBusError&)),
-                                        HANGUP_TIMEOUT);
+    m_scheduler->schedule(OfonoCallScheduler::ControlLane, m_if->connection().bus(), request,
+                          HANGUP_TIMEOUT, [this](const QDBusPendingCall &call) {
+        if (call.isError())
+            hangupAllErr(call.error());
+        else
+            hangupAllResp();
+    });
 }
 
 void OfonoVoiceCallManager::sendTones(const QString &tonestring)
 {
+    // the string goes out in chunks, so that a hangup queued behind a long
+    // string only waits for the chunk in flight; all chunks are queued at
+    // once so that the tones of two strings cannot interleave
+    QStringList chunks;
+    int pos = 0;
+    do {
+        chunks << tonestring.mid(pos, TONE_CHUNK_LENGTH);
+        pos += TONE_CHUNK_LENGTH;
+    } while (pos < tonestring.length());
+
+    QSharedPointer<ToneSequence> sequence(new ToneSequence);
+    sequence->remaining = chunks.count();
+    sequence->done = false;
+    QDBusConnection bus = m_if->connection().bus();
+    foreach (QString chunk, chunks) {
+        QDBusMessage request;
+        request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                 path(), m_if->ifname(),
+                                                 "SendTones");
+        request.setArguments(QList<QVariant>() << QVariant(chunk));
+        int timeout = TONE_TIMEOUT*qMax(1, chunk.length());
+
+        m_scheduler->schedule(OfonoCallScheduler::ToneLane, [bus, request, timeout, sequence]() {
+            // the rest of a string is not sent once a chunk has failed
+            if (sequence->done)
+                return QDBusPendingCall::fromError(QDBusError(QDBusError::Other, "Operation cancelled"));
+            return bus.asyncCall(request, timeout);
+        }, [this, sequence](const QDBusPendingCall &call) {
+            if (sequence->done)
+                return;
+            if (call.isError()) {
+                sequence->done = true;
+                sendTonesErr(call.error());
+            } else if (--sequence->remaining == 0) {
+                sequence->done = true;
+                sendTonesResp();
+            }
+        });
+    }
+}
+
+void OfonoVoiceCallManager::queueTones(const QString &tones)
+{
+    QString chunk;
+    foreach (QChar c, tones) {
+        if (c.isSpace())
+            continue;
+        if (c == ',' || c == 'p' || c == 'P') {
+            if (!chunk.isEmpty())
+                m_toneChunks << chunk;
+            chunk.clear();
+            m_toneChunks << QString(",");
+            continue;
+        }
+        chunk.append(c);
+        m_tonesTotal++;
+        if (chunk.length() == TONE_CHUNK_LENGTH) {
+            m_toneChunks << chunk;
+            chunk.clear();
+        }
+    }
+    if (!chunk.isEmpty())
+        m_toneChunks << chunk;
+
+    if (m_toneCall.isEmpty()) {
+        foreach (OfonoVoiceCall *call, m_calls) {
+            if (call->state() == "active") {
+                m_toneCall = call->path();
+                break;
+            }
+        }
+    }
+    sendNextTones();
+}
+
+void OfonoVoiceCallManager::cancelTones()
+{
+    if (!m_toneChunks.isEmpty() || m_toneInFlight || m_tonePause->isActive())
+        finishTones(false);
+    // also drops tones queued with sendTones()
+    m_scheduler->cancel(OfonoCallScheduler::ToneLane);
+}
+
+void OfonoVoiceCallManager::sendNextTones()
+{
+    if (m_toneInFlight || m_tonePause->isActive())
+        return;
+    // this also completes a queue of nothing but pauses, or of nothing
+    if (m_toneChunks.isEmpty()) {
+        finishTones(true);
+        return;
+    }
+
+    QString chunk = m_toneChunks.takeFirst();
+    if (chunk == ",") {
+        m_tonePause->start(TONE_PAUSE);
+        return;
+    }
+
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "SendTones");
-    QList<QVariant>arg;
-    arg.append(QVariant(tonestring));
-    request.setArguments(arg);
+    request.setArguments(QList<QVariant>() << QVariant(chunk));
+
+    m_toneInFlight = true;
+    m_toneChunkLength = chunk.length();
+    quint32 generation = m_toneGeneration;
+    m_scheduler->schedule(OfonoCallScheduler::ToneLane, m_if->connection().bus(), request,
+                          TONE_TIMEOUT, [this, generation](const QDBusPendingCall &call) {
+        queueTonesFinished(call, generation);
+    });
+}
+
+void OfonoVoiceCallManager::queueTonesFinished(const QDBusPendingCall &call, quint32 generation)
+{
+    // the reply to a chunk of a cancelled queue
+    if (generation != m_toneGeneration)
+        return;
+    m_toneInFlight = false;
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(sendTonesResp()),
-                                        SLOT(sendTonesErr(const QDBusError&)),
-                                        (TONE_TIMEOUT*tonestring.length()));
+    if (call.isError()) {
+        m_if->setError(call.error().name(), call.error().message());
+        finishTones(false);
+        return;
+    }
+    m_tonesSent += m_toneChunkLength;
+    emit tonesProgress(m_tonesSent, m_tonesTotal);
+    sendNextTones();
+}
+
+void OfonoVoiceCallManager::finishTones(bool status)
+{
+    m_toneChunks.clear();
+    m_tonePause->stop();
+    m_toneInFlight = false;
+    m_toneGeneration++;
+    m_tonesTotal = 0;
+    m_tonesSent = 0;
+    m_toneCall.clear();
+    emit queueTonesComplete(status);
 }
 
 void OfonoVoiceCallManager::transfer()
 {
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "Transfer");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(transferResp()),
-                                        SLOT(transferErr(const QDBusError&)),
-                                        TRANSFER_TIMEOUT);
+    m_scheduler->schedule(OfonoCallScheduler::ControlLane, m_if->connection().bus(), request,
+                          TRANSFER_TIMEOUT, [this](const QDBusPendingCall &call) {
+        if (call.isError())
+            transferErr(call.error());
+        else
+            transferResp();
+    });
 }
 
 void OfonoVoiceCallManager::swapCalls()
 {
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "SwapCalls");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(swapCallsResp()),
-                                        SLOT(swapCallsErr(const QDBusError&)),
-                                        SWAP_TIMEOUT);
+    m_scheduler->schedule(OfonoCallScheduler::ControlLane, m_if->connection().bus(), request,
+                          SWAP_TIMEOUT, [this](const QDBusPendingCall &call) {
+        if (call.isError())
+            swapCallsErr(call.error());
+        else
+            swapCallsResp();
+    });
 }
 
 void OfonoVoiceCallManager::releaseAndAnswer()
 {
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "ReleaseAndAnswer");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(releaseAndAnswerResp()),
-                                        SLOT(releaseAndAnswerErr(const QDBusError&)),
-                                        HANGUP_TIMEOUT);
+    m_scheduler->schedule(OfonoCallScheduler::ControlLane, m_if->connection().bus(), request,
+                          HANGUP_TIMEOUT, [this](const QDBusPendingCall &call) {
+        if (call.isError())
+            releaseAndAnswerErr(call.error());
+        else
+            releaseAndAnswerResp();
+    });
 }
 
 void OfonoVoiceCallManager::holdAndAnswer()
 {
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "HoldAndAnswer");
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(holdAndAnswerResp()),
-                                        SLOT(holdAndAnswerErr(const QDBusError&)),
-                                        HOLD_TIMEOUT);
+    m_scheduler->schedule(OfonoCallScheduler::ControlLane, m_if->connection().bus(), request,
+                          HOLD_TIMEOUT, [this](const QDBusPendingCall &call) {
+        if (call.isError())
+            holdAndAnswerErr(call.error());
+        else
+            holdAndAnswerResp();
+    });
 }
 
-void OfonoVoiceCallManager::privateChat(const QString &call)
+void OfonoVoiceCallManager::scheduleMultiparty(const QString &method, const QVariantList &arguments,
+                                               int timeout, const OfonoCallScheduler::Finish &finish)
 {
     QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
-                                             "PrivateChat");
+                                             method);
+    request.setArguments(arguments);
+    m_scheduler->schedule(OfonoCallScheduler::MultipartyLane, m_if->connection().bus(), request,
+                          timeout, finish);
+}
 
-    QList<QVariant>arg;
+void OfonoVoiceCallManager::privateChat(const QString &call)
+{
+    QVariantList arg;
     arg.append(QVariant::fromValue(QDBusObjectPath(call)));
-    request.setArguments(arg);
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(privateChatResp(const QList<QDBusObjectPath>&)),
-                                        SLOT(privateChatErr(const QDBusError&)),
-                                        PRIVATE_CHAT_TIMEOUT);
+    scheduleMultiparty("PrivateChat", arg, PRIVATE_CHAT_TIMEOUT, [this](const QDBusPendingCall &pending) {
+        if (pending.isError()) {
+            privateChatErr(pending.error());
+        } else {
+            QDBusPendingReply<QList<QDBusObjectPath> > reply = pending;
+            privateChatResp(reply.value());
+        }
+    });
 }
 
 QList<QDBusObjectPath> OfonoVoiceCallManager::createMultiparty()
 {
     QDBusMessage request;
     QDBusReply<QList<QDBusObjectPath> > reply;
-    request = QDBusMessage::createMethodCall("org.ofono",
-                                             path(), m_if->ifname(),
-                                             "CreateMultiparty");
-
-    request = QDBusMessage::createMethodCall("org.ofono",
+    request = QDBusMessage::createMethodCall(m_if->connection().service(),
                                              path(), m_if->ifname(),
                                              "CreateMultiparty");
-    reply = QDBusConnection::systemBus().call(request);
+    QElapsedTimer timer;
+    timer.start();
+    reply = m_if->connection().bus().call(request, QDBus::Block, CREATE_MULTIPARTY_TIMEOUT);
     bool success = reply.isValid();
     if (!success) {
         m_if->setError(reply.error().name(), reply.error().message());
     }
+    m_scheduler->recordSynchronous(OfonoCallScheduler::MultipartyLane, timer.nsecsElapsed() / 1000, success);
+    if (success)
+        createMultipartyResp(reply.value());
+    else
+        emit createMultipartyComplete(false, QStringList());
     return reply;
 }
 
-void OfonoVoiceCallManager::hangupMultiparty()
+void OfonoVoiceCallManager::createMultipartyAsync()
 {
-    QDBusMessage request;
-    request = QDBusMessage::createMethodCall("org.ofono",
-                                             path(), m_if->ifname(),
-                                             "HangupMultiparty");
+    scheduleMultiparty("CreateMultiparty", QVariantList(), CREATE_MULTIPARTY_TIMEOUT,
+                       [this](const QDBusPendingCall &pending) {
+        if (pending.isError()) {
+            createMultipartyErr(pending.error());
+        } else {
+            QDBusPendingReply<QList<QDBusObjectPath> > reply = pending;
+            createMultipartyResp(reply.value());
+        }
+    });
+}
 
-    QDBusConnection::systemBus().callWithCallback(request, this,
-                                        SLOT(hangupMultipartyResp()),
-                                        SLOT(hangupMultipartyErr(const QDBusError&)),
-                                        HANGUP_TIMEOUT);
+void OfonoVoiceCallManager::hangupMultiparty()
+{
+    scheduleMultiparty("HangupMultiparty", QVariantList(), HANGUP_TIMEOUT, [this](const QDBusPendingCall &call) {
+        if (call.isError())
+            hangupMultipartyErr(call.error());
+        else
+            hangupMultipartyResp();
+    });
 }
 
 void OfonoVoiceCallManager::hangupMultipartyResp()
@@ -360,6 +684,17 @@ void OfonoVoiceCallManager::swapCallsErr(const QDBusError &error)
     emit swapCallsComplete(false);
 }
 
+void OfonoVoiceCallManager::dialResp(const QDBusObjectPath &path)
+{
+    emit dialComplete(true, path.path());
+}
+
+void OfonoVoiceCallManager::dialErr(const QDBusError &error)
+{
+    m_if->setError(error.name(), error.message());
+    emit dialComplete(false, QString());
+}
+
 void OfonoVoiceCallManager::hangupAllResp()
 {
     emit hangupAllComplete(true);
@@ -397,26 +732,81 @@ QStringList OfonoVoiceCallManager::emergencyNumbers() const
     return m_if->properties()["EmergencyNumbers"].value<QStringList>();
 }
 
+bool OfonoVoiceCallManager::isEmergencyNumber(const QString &number) const
+{
+    return m_emergencyNumbers.contains(dialedDigits(number));
+}
+
+void OfonoVoiceCallManager::setEmergencyNumbers(const QStringList &numbers)
+{
+    m_emergencyNumbers.clear();
+    m_emergencyNumbers.reserve(numbers.count());
+    foreach (QString number, numbers)
+        m_emergencyNumbers.insert(dialedDigits(number));
+}
+
 void OfonoVoiceCallManager::propertyChanged(const QString &property, const QVariant &value)
 {
     if (property == "EmergencyNumbers") {	
+        setEmergencyNumbers(value.value<QStringList>());
         emit emergencyNumbersChanged(value.value<QStringList>());
     }
 }
 
 QStringList OfonoVoiceCallManager::getCalls() const
 {
-    return m_calllist;
+    return m_calllist.toList();
 }
 
 void OfonoVoiceCallManager::callAddedChanged(const QDBusObjectPath &path, const QVariantMap& values)
 {
-    m_calllist << path.path();
+    m_calllist.insert(path.path());
+    OfonoPropertyCache::forConnection(m_if->connection())->seed(path.path(), "org.ofono.VoiceCall", values);
+    addCallObject(path.path());
+    OfonoEventBus::instance()->publish(OfonoEvent::CallAdded, path.path(), "org.ofono.VoiceCall", values);
     emit callAdded(path.path(), values);
 }
 
 void OfonoVoiceCallManager::callRemovedChanged(const QDBusObjectPath &path)
 {
-    m_calllist.removeAll(path.path());
+    m_calllist.remove(path.path());
+    OfonoEventBus::instance()->publish(OfonoEvent::CallRemoved, path.path(), "org.ofono.VoiceCall");
     emit callRemoved(path.path());
+    removeCallObject(path.path());
+
+    if (path.path() == m_toneCall || m_calllist.isEmpty())
+        cancelTones();
+}
+
+void OfonoVoiceCallManager::onServiceLost()
+{
+    foreach (QString call, m_calllist.toList())
+        callRemovedChanged(QDBusObjectPath(call));
+}
+
+void OfonoVoiceCallManager::onServiceReturned()
+{
+    if (path() == "/")
+        return;
+
+    QDBusMessage request = QDBusMessage::createMethodCall(m_if->connection().service(),
+                                                          path(), m_if->ifname(),
+                                                          "GetCalls");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_if->connection().bus().asyncCall(request), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
+            this, SLOT(resyncCallsFinished(QDBusPendingCallWatcher*)));
+    OfonoServiceTracker::forConnection(m_if->connection())->addFetch(watcher);
+}
+
+void OfonoVoiceCallManager::resyncCallsFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<OfonoVoiceCallManagerList> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError())
+        return;
+    foreach (OfonoVoiceCallManagerStruct call, reply.value()) {
+        if (!m_calllist.contains(call.path.path()))
+            callAddedChanged(call.path, call.properties);
+    }
 }
@@ -29,12 +29,20 @@
 
 #include <QtCore/QObject>
 #include <QStringList>
+#include <QHash>
+#include <QSet>
 #include <QDBusError>
 #include <QDBusObjectPath>
 
 #include "ofonomodeminterface.h"
+#include "ofonopathset.h"
+#include "ofonocallscheduler.h"
 #include "libofono-qt_global.h"
 
+class QDBusPendingCallWatcher;
+class QTimer;
+class OfonoVoiceCall;
+
 struct OfonoVoiceCallManagerStruct {
     QDBusObjectPath path;
     QVariantMap properties;
@@ -48,6 +56,11 @@ Q_DECLARE_METATYPE(OfonoVoiceCallManagerList)
 /*!
  * The API is documented in
  * http://git.kernel.org/?p=network/ofono/ofono.git;a=blob_plain;f=doc/voicecallmanager-api.txt
+ *
+ * The manager keeps one OfonoVoiceCall object for every call, built from
+ * the properties in the GetCalls reply and the CallAdded signal, so
+ * constructing it costs no D-Bus round trip. All users of the manager
+ * share these objects; see call().
  */
 class OFONO_QT_EXPORT OfonoVoiceCallManager : public OfonoModemInterface
 {
@@ -57,31 +70,120 @@ class OFONO_QT_EXPORT OfonoVoiceCallManager : public OfonoModemInterface
 
 public:
     OfonoVoiceCallManager(OfonoModem::SelectionSetting modemSetting, const QString &modemPath, QObject *parent=0);
+    //! Constructs the object on top of an existing modem object, see OfonoModemHub
+    explicit OfonoVoiceCallManager(OfonoModem *modem, QObject *parent=0);
     ~OfonoVoiceCallManager();
 
     /* Properties */
     QStringList emergencyNumbers() const;
 
+    //! Returns true if dialing the number reaches an emergency service
+    /*!
+     * Separators such as spaces and dashes, a leading '+', the "*31#" and
+     * "#31#" caller id prefixes and anything after a pause character are
+     * ignored. The lookup is a single hash lookup; the set is rebuilt only
+     * when the EmergencyNumbers property changes.
+     */
+    bool isEmergencyNumber(const QString &number) const;
+
     Q_INVOKABLE QStringList getCalls() const;
 
+    //! Returns the calls as a set, for constant-time lookups
+    const OfonoPathSet &callPaths() const {return m_calllist;}
+
+    //! Returns the call object of a call, or 0 if there is no such call
+    /*!
+     * The object is owned by the manager. It exists by the time callAdded()
+     * is issued and is deleted after callRemoved(), so keep it in a QPointer
+     * if it is stored.
+     */
+    OfonoVoiceCall *call(const QString &path) const {return m_calls.value(path);}
+
+    //! Returns the call objects of all calls, in the order they were added
+    QList<OfonoVoiceCall*> callObjects() const;
+
+    //! Returns the scheduler that sends the asynchronous operations
+    /*!
+     * Operations are sent one at a time, most urgent first: emergency calls
+     * go ahead of dialing, hangup, answer, hold, swap and transfer, which go
+     * ahead of multiparty operations, which go ahead of tones. The scheduler
+     * also keeps per-lane latency statistics.
+     */
+    OfonoCallScheduler *scheduler() const {return m_scheduler;}
+
+    //! Queues a multiparty method call of the voice call manager interface
+    /*!
+     * The call is sent through the multiparty lane of scheduler(), in turn
+     * with the multiparty operations of this object, and \a finish is called
+     * with its reply, or with an error if the lane is cancelled. This is
+     * meant for helpers such as OfonoConference that report the outcome of
+     * their own requests.
+     */
+    void scheduleMultiparty(const QString &method, const QVariantList &arguments,
+                            int timeout, const OfonoCallScheduler::Finish &finish);
+
+    //! Returns the number of queued tones that have not been sent yet
+    int pendingTones() const {return m_tonesTotal - m_tonesSent;}
+
 public Q_SLOTS:
+    //! Dials a number and blocks until oFono replies
+    /*!
+     * The call waits for its turn in scheduler() like dialAsync() does, so
+     * it also waits for the operation in flight and the ones queued ahead.
+     */
     QDBusObjectPath dial(const QString &number, const QString &callerid_hide, bool &success);
+    //! Dials a number, reporting with dialComplete()
+    /*!
+     * An emergency number, see isEmergencyNumber(), is dialed ahead of all
+     * queued operations; queued tones are sent after it.
+     */
+    void dialAsync(const QString &number, const QString &callerid_hide);
     void hangupAll();
+    //! Sends tones; sendTonesComplete() is issued once the whole string is sent
+    /*!
+     * The string is sent in chunks of at most eight tones, so more urgent
+     * operations do not wait for all of it; see scheduler().
+     */
     void sendTones(const QString &tonestring);
+    //! Sends tones in chunks, one chunk after another
+    /*!
+     * The tones are appended to a queue that is sent in chunks of at most
+     * eight tones, each with a deadline of its own; the next chunk is sent as
+     * soon as oFono has acknowledged the previous one, and tonesProgress() is
+     * issued after each chunk. A ',' or 'p' pauses the sequence for two
+     * seconds. Whitespace is ignored.
+     *
+     * queueTonesComplete() is issued when the queue has been sent, right
+     * away if there is nothing to send, or with false when a chunk fails or
+     * the queue is cancelled. The queue is
+     * cancelled when the call that was active when it was started goes away.
+     */
+    void queueTones(const QString &tones);
+    //! Drops the tones that have not been sent yet
+    void cancelTones();
     void transfer();
     void swapCalls();
     void releaseAndAnswer();
     void holdAndAnswer();
     void privateChat(const QString &path);
+    //! Joins the active and held calls into a multiparty call
+    /*!
+     * This call blocks until oFono replies; createMultipartyAsync() does not.
+     */
     QList<QDBusObjectPath> createMultiparty();
+    //! Joins the active and held calls, reporting with createMultipartyComplete()
+    void createMultipartyAsync();
     void hangupMultiparty();
 
 Q_SIGNALS:
     void emergencyNumbersChanged(const QStringList &numbers);
     void callAdded(const QString &call, const QVariantMap &values);
     void callRemoved(const QString &call);
+    void dialComplete(const bool status, const QString &call);
     void hangupAllComplete(const bool status);
     void sendTonesComplete(const bool status);
+    void tonesProgress(int sent, int total);
+    void queueTonesComplete(const bool status);
     void transferComplete(const bool status);
     void swapCallsComplete(const bool status);
     void releaseAndAnswerComplete(const bool status);
@@ -99,10 +201,17 @@ private Q_SLOTS:
     void propertyChanged(const QString &property, const QVariant &value);
     void callAddedChanged(const QDBusObjectPath &call, const QVariantMap &values);
     void callRemovedChanged(const QDBusObjectPath &call);
+    void onServiceLost();
+    void onServiceReturned();
+    void resyncCallsFinished(QDBusPendingCallWatcher *watcher);
+    void refreshCallsFinished(QDBusPendingCallWatcher *watcher);
+    void dialResp(const QDBusObjectPath &path);
+    void dialErr(const QDBusError &error);
     void hangupAllResp();
     void hangupAllErr(const QDBusError &error);
     void sendTonesResp();
     void sendTonesErr(const QDBusError &error);
+    void sendNextTones();
     void transferResp();
     void transferErr(const QDBusError &error);
     void swapCallsResp();
@@ -120,9 +229,31 @@ private Q_SLOTS:
 
 private:
     QStringList getCallList();
+    QStringList callPaths(const OfonoVoiceCallManagerList &calls);
+    QDBusMessage dialRequest(const QString &number, const QString &callerid_hide) const;
+    OfonoCallScheduler::Lane dialLane(const QString &number) const;
+    void addCallObject(const QString &path);
+    void removeCallObject(const QString &path);
+    void syncCallObjects();
     void connectDbusSignals(const QString& path);
+    void queueTonesFinished(const QDBusPendingCall &call, quint32 generation);
+    void finishTones(bool status);
+    void setEmergencyNumbers(const QStringList &numbers);
 private:
-    QStringList m_calllist;
+    void init();
+    OfonoPathSet m_calllist;
+    QHash<QString, OfonoVoiceCall*> m_calls;
+    QSet<QString> m_emergencyNumbers;
+    QStringList m_toneChunks;
+    int m_tonesTotal;
+    int m_tonesSent;
+    QString m_toneCall;
+    bool m_toneInFlight;
+    quint32 m_toneGeneration;
+    int m_toneChunkLength;
+    QTimer *m_tonePause;
+    OfonoCallScheduler *m_scheduler;
+    QDBusPendingCallWatcher *m_refreshWatcher;
 };
 
 #endif  /* !OFONOVOICECALLMANAGER_H */
@@ -0,0 +1,158 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QTemporaryDir>
+
+#include <ofonocallhistory.h>
+
+#include <QtDebug>
+
+static OfonoCallHistoryEntry makeEntry(const QString &number, qint64 time,
+                                       OfonoCallHistoryEntry::Direction direction, bool answered)
+{
+    OfonoCallHistoryEntry entry;
+    entry.number = number;
+    entry.time = time;
+    entry.duration = answered ? 1000 : 0;
+    entry.direction = direction;
+    entry.answered = answered;
+    return entry;
+}
+
+class TestOfonoCallHistory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testNormalize()
+    {
+        QCOMPARE(OfonoCallHistory::normalizeNumber("+358 (40) 123-4567"), QString("+358401234567"));
+        QCOMPARE(OfonoCallHistory::normalizeNumber("00358 40 1234567"), QString("+358401234567"));
+        QCOMPARE(OfonoCallHistory::normalizeNumber("*31#123"), QString("*31#123"));
+    }
+
+    void testQueries()
+    {
+        OfonoCallHistory h(0);
+        QSignalSpy added(&h, SIGNAL(entryAdded(const OfonoCallHistoryEntry&)));
+
+        h.add(makeEntry("123", 100, OfonoCallHistoryEntry::Incoming, true));
+        h.add(makeEntry("456", 200, OfonoCallHistoryEntry::Incoming, false));
+        h.add(makeEntry("1 2 3", 300, OfonoCallHistoryEntry::Outgoing, true));
+        h.add(makeEntry("123", 400, OfonoCallHistoryEntry::Incoming, false));
+        // a long call that ended after a later one
+        h.add(makeEntry("789", 250, OfonoCallHistoryEntry::Incoming, false));
+        QCOMPARE(added.count(), 5);
+        QCOMPARE(h.count(), 5);
+
+        QList<OfonoCallHistoryEntry> last = h.lastCalls("123", 2);
+        QCOMPARE(last.count(), 2);
+        QCOMPARE(last.at(0).time, qint64(300));
+        QCOMPARE(last.at(1).time, qint64(400));
+        QCOMPARE(h.lastCalls("123", 10).count(), 3);
+        QCOMPARE(h.lastCalls("000", 10).count(), 0);
+
+        QList<OfonoCallHistoryEntry> missed = h.missedCalls(200);
+        QCOMPARE(missed.count(), 3);
+        QCOMPARE(missed.at(0).number, QString("456"));
+        QCOMPARE(missed.at(1).number, QString("789"));
+        QCOMPARE(missed.at(2).number, QString("123"));
+        QCOMPARE(h.missedCalls(401).count(), 0);
+
+        QCOMPARE(h.calls(OfonoCallHistoryEntry::Outgoing, 0).count(), 1);
+        QCOMPARE(h.calls(OfonoCallHistoryEntry::Incoming, 150).count(), 3);
+
+        QList<OfonoCallHistoryEntry> recent = h.calls(250);
+        QCOMPARE(recent.count(), 3);
+        QCOMPARE(recent.at(0).number, QString("789"));
+        QCOMPARE(recent.at(2).time, qint64(400));
+    }
+
+    void testFile()
+    {
+        QTemporaryDir dir;
+        QString fileName = dir.path() + "/history";
+        {
+            OfonoCallHistory h(0);
+            QVERIFY(h.open(fileName));
+            for (int i = 0; i < 1000; i++)
+                h.add(makeEntry(QString::number(i % 10), i, OfonoCallHistoryEntry::Incoming, i % 2));
+        }
+
+        // a record cut short by a crash is dropped
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write("\x00\x00", 2);
+        file.close();
+
+        OfonoCallHistory h(0);
+        QVERIFY(h.open(fileName));
+        QCOMPARE(h.count(), 1000);
+        QCOMPARE(h.lastCalls("7", 1).at(0).time, qint64(997));
+        QCOMPARE(h.missedCalls(900).count(), 50);
+        h.add(makeEntry("7", 1000, OfonoCallHistoryEntry::Outgoing, true));
+        h.close();
+
+        QVERIFY(h.open(fileName));
+        QCOMPARE(h.count(), 1001);
+        QCOMPARE(h.at(1000).direction, OfonoCallHistoryEntry::Outgoing);
+    }
+
+    void testBadRecord()
+    {
+        QTemporaryDir dir;
+        QString fileName = dir.path() + "/history";
+        {
+            OfonoCallHistory h(0);
+            QVERIFY(h.open(fileName));
+            h.add(makeEntry("123", 100, OfonoCallHistoryEntry::Incoming, true));
+        }
+
+        // a complete record with a direction that does not exist
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::Append));
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream << QString("456") << qint64(200) << qint32(0) << quint8(7) << quint8(0);
+        file.close();
+
+        OfonoCallHistory h(0);
+        QVERIFY(h.open(fileName));
+        QCOMPARE(h.count(), 1);
+        QCOMPARE(h.calls(0).count(), 1);
+        h.add(makeEntry("789", 300, OfonoCallHistoryEntry::Outgoing, true));
+        h.add(makeEntry("000", 400, OfonoCallHistoryEntry::Direction(7), true));
+        QCOMPARE(h.count(), 2);
+        h.close();
+
+        QVERIFY(h.open(fileName));
+        QCOMPARE(h.count(), 2);
+        QCOMPARE(h.at(1).number, QString("789"));
+    }
+};
+
+QTEST_MAIN(TestOfonoCallHistory)
+#include "test_ofonocallhistory.moc"
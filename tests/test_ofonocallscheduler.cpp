@@ -0,0 +1,149 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QDBusMessage>
+#include <QDBusError>
+
+#include <ofonocallscheduler.h>
+
+#include <QtDebug>
+
+class TestOfonoCallScheduler : public QObject
+{
+    Q_OBJECT
+
+    // an operation that completes right away and logs when it is sent
+    OfonoCallScheduler::Start op(const QString &name, bool fail = false)
+    {
+        return [this, name, fail]() {
+            sent << name;
+            if (fail)
+                return QDBusPendingCall::fromError(QDBusError(QDBusError::Failed, name));
+            QDBusMessage request = QDBusMessage::createMethodCall("org.ofono", "/", "org.ofono.Test", "Test");
+            return QDBusPendingCall::fromCompletedCall(request.createReply());
+        };
+    }
+
+    OfonoCallScheduler::Finish done(const QString &name)
+    {
+        return [this, name](const QDBusPendingCall &call) {
+            finished << (call.isError() ? "!" + name : name);
+        };
+    }
+
+private slots:
+
+    void init()
+    {
+        sent.clear();
+        finished.clear();
+    }
+
+    void testPriority()
+    {
+        OfonoCallScheduler s;
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone1"), done("tone1"));
+        QVERIFY(s.isBusy());
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone2"), done("tone2"));
+        s.schedule(OfonoCallScheduler::MultipartyLane, op("mpty", true), done("mpty"));
+        s.schedule(OfonoCallScheduler::ControlLane, op("hangup"), done("hangup"));
+        s.schedule(OfonoCallScheduler::EmergencyLane, op("112"), done("112"));
+        QCOMPARE(s.pending(OfonoCallScheduler::ToneLane), 1);
+
+        QTest::qWait(100);
+        QCOMPARE(finished.count(), 5);
+        QVERIFY(!s.isBusy());
+        // the tone in flight is not interrupted, the queued one waits
+        QCOMPARE(sent, QStringList() << "tone1" << "112" << "hangup" << "mpty" << "tone2");
+        QCOMPARE(finished, QStringList() << "tone1" << "112" << "hangup" << "!mpty" << "tone2");
+
+        OfonoCallScheduler::LaneStats tones = s.stats(OfonoCallScheduler::ToneLane);
+        QCOMPARE(tones.completed, quint64(2));
+        QCOMPARE(tones.overtaken, quint64(2));
+        QVERIFY(tones.maxLatency >= tones.maxWait);
+        OfonoCallScheduler::LaneStats mpty = s.stats(OfonoCallScheduler::MultipartyLane);
+        QCOMPARE(mpty.failed, quint64(1));
+        QCOMPARE(mpty.overtaken, quint64(1));
+        QCOMPARE(s.stats(OfonoCallScheduler::ControlLane).completed, quint64(1));
+        QCOMPARE(s.stats(OfonoCallScheduler::EmergencyLane).completed, quint64(1));
+
+        s.recordSynchronous(OfonoCallScheduler::MultipartyLane, 1500, true);
+        QCOMPARE(s.stats(OfonoCallScheduler::MultipartyLane).maxLatency, qint64(1500));
+        s.resetStats();
+        QCOMPARE(s.stats(OfonoCallScheduler::ToneLane).completed, quint64(0));
+    }
+
+    void testExecute()
+    {
+        OfonoCallScheduler s;
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone1"), done("tone1"));
+        s.schedule(OfonoCallScheduler::ControlLane, op("hangup"), done("hangup"));
+
+        // waits for the operations sent ahead of it
+        QDBusPendingCall reply = s.execute(OfonoCallScheduler::ControlLane, op("dial"));
+        QVERIFY(!reply.isError());
+        QCOMPARE(sent, QStringList() << "tone1" << "hangup" << "dial");
+        QCOMPARE(finished, QStringList() << "tone1" << "hangup");
+        QCOMPARE(s.stats(OfonoCallScheduler::ControlLane).completed, quint64(2));
+
+        QVERIFY(s.execute(OfonoCallScheduler::EmergencyLane, op("112", true)).isError());
+        QCOMPARE(s.stats(OfonoCallScheduler::EmergencyLane).failed, quint64(1));
+
+        // an emergency call passes queued tones, which stay queued
+        sent.clear();
+        finished.clear();
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone2"), done("tone2"));
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone3"), done("tone3"));
+        reply = s.execute(OfonoCallScheduler::EmergencyLane, op("112"));
+        QVERIFY(!reply.isError());
+        QCOMPARE(sent, QStringList() << "tone2" << "112" << "tone3");
+        QCOMPARE(finished, QStringList() << "tone2");
+        QCOMPARE(s.stats(OfonoCallScheduler::ToneLane).cancelled, quint64(0));
+        QTest::qWait(100);
+        QCOMPARE(finished, QStringList() << "tone2" << "tone3");
+    }
+
+    void testCancel()
+    {
+        OfonoCallScheduler s;
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone1"), done("tone1"));
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone2"), done("tone2"));
+        s.schedule(OfonoCallScheduler::ToneLane, op("tone3"), done("tone3"));
+        QCOMPARE(s.cancel(OfonoCallScheduler::ToneLane), 2);
+        QCOMPARE(finished, QStringList() << "!tone2" << "!tone3");
+
+        QTest::qWait(100);
+        QCOMPARE(finished.count(), 3);
+        QCOMPARE(sent, QStringList() << "tone1");
+        QCOMPARE(s.stats(OfonoCallScheduler::ToneLane).cancelled, quint64(2));
+    }
+
+private:
+    QStringList sent;
+    QStringList finished;
+};
+
+QTEST_MAIN(TestOfonoCallScheduler)
+#include "test_ofonocallscheduler.moc"
@@ -0,0 +1,2 @@
+include(testcase.pri)
+SOURCES += test_ofonocallscheduler.cpp
@@ -0,0 +1,107 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonocalltimeline.h>
+
+#include <QtDebug>
+
+static const qint64 ms = 1000000;
+
+class TestOfonoCallTimeline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testOutgoingCall()
+    {
+        OfonoCallTimeline t;
+        QCOMPARE(t.state(), OfonoCallTimeline::UnknownState);
+        QCOMPARE(t.postDialDelay(), qint64(-1));
+        QCOMPARE(t.answerTime(), qint64(-1));
+        QCOMPARE(t.holdTime(), qint64(0));
+
+        t.record("dialing", 1000 * ms);
+        t.record("alerting", 1800 * ms);
+        t.record("alerting", 1900 * ms);
+        t.record("active", 4000 * ms);
+        t.record("held", 5000 * ms);
+        t.record("active", 7500 * ms);
+        t.recordDisconnectReason("remote", 9000 * ms);
+        t.record("disconnected", 9000 * ms);
+
+        QCOMPARE(t.count(), 6);
+        QCOMPARE(t.recorded(), 6);
+        QCOMPARE(t.at(0).state, OfonoCallTimeline::DialingState);
+        QCOMPARE(t.at(1).timestamp, 1800 * ms);
+        QCOMPARE(t.state(), OfonoCallTimeline::DisconnectedState);
+        QCOMPARE(t.disconnectReason(), QString("remote"));
+        QCOMPARE(t.postDialDelay(), qint64(800));
+        QCOMPARE(t.answerTime(), qint64(3000));
+        QCOMPARE(t.holdTime(), qint64(2500));
+    }
+
+    void testIncomingCall()
+    {
+        OfonoCallTimeline t;
+        t.record("incoming", 100 * ms);
+        t.record("active", 2100 * ms);
+        QCOMPARE(t.postDialDelay(), qint64(-1));
+        QCOMPARE(t.answerTime(), qint64(2000));
+    }
+
+    void testWrap()
+    {
+        OfonoCallTimeline t;
+        t.record("dialing", 0);
+        t.record("alerting", 500 * ms);
+        t.record("active", 1000 * ms);
+        for (int i = 0; i < OfonoCallTimeline::Capacity; i++) {
+            t.record("held", (2000 + i * 200) * ms);
+            t.record("active", (2100 + i * 200) * ms);
+        }
+
+        QCOMPARE(t.count(), int(OfonoCallTimeline::Capacity));
+        QCOMPARE(t.recorded(), 3 + 2 * OfonoCallTimeline::Capacity);
+        QCOMPARE(t.at(t.count() - 1).state, OfonoCallTimeline::ActiveState);
+        // the metrics survive the events they were derived from
+        QCOMPARE(t.postDialDelay(), qint64(500));
+        QCOMPARE(t.answerTime(), qint64(1000));
+        QCOMPARE(t.holdTime(), qint64(100 * OfonoCallTimeline::Capacity));
+    }
+
+    void testStateNames()
+    {
+        QCOMPARE(OfonoCallTimeline::stateFromString("waiting"), OfonoCallTimeline::WaitingState);
+        QCOMPARE(OfonoCallTimeline::stateFromString("bogus"), OfonoCallTimeline::UnknownState);
+        QCOMPARE(OfonoCallTimeline::stateName(OfonoCallTimeline::HeldState), QString("held"));
+        qint64 a = OfonoCallTimeline::now();
+        QVERIFY(OfonoCallTimeline::now() >= a);
+    }
+};
+
+QTEST_MAIN(TestOfonoCallTimeline)
+#include "test_ofonocalltimeline.moc"
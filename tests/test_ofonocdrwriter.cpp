@@ -0,0 +1,122 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QTemporaryDir>
+#include <string.h>
+
+#include <ofonocdrwriter.h>
+#include <ofonocdrreader.h>
+
+#include <QtDebug>
+
+static OfonoCdrRecord makeRecord(int i)
+{
+    OfonoCdrRecord record;
+    memset(&record, 0, sizeof(record));
+    record.addedAt = 1000 * i;
+    record.startTime = -1;
+    record.removedAt = 1000 * i + 500;
+    record.answerTime = i;
+    record.cellId = i;
+    record.direction = OfonoCdrRecord::Outgoing;
+    qsnprintf(record.number, sizeof(record.number), "%d", i);
+    return record;
+}
+
+class TestOfonoCdrWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testWriteRead()
+    {
+        QTemporaryDir dir;
+        QString fileName = dir.path() + "/calls.cdr";
+        int n = OfonoCdrWriter::GrowRecords + 10;
+
+        OfonoCdrWriter writer(0);
+        QVERIFY(writer.open(fileName));
+        QSignalSpy written(&writer, SIGNAL(recordWritten(const OfonoCdrRecord&)));
+        for (int i = 0; i < n; i++)
+            QVERIFY(writer.append(makeRecord(i)));
+        QCOMPARE(written.count(), n);
+        QCOMPARE(writer.count(), qint64(n));
+        QVERIFY(writer.sync());
+
+        // a reader sees the records while the writer has the file open
+        OfonoCdrReader reader;
+        QVERIFY(reader.open(fileName));
+        QCOMPARE(reader.count(), qint64(n));
+        OfonoCdrRecord record = reader.at(n - 1);
+        QCOMPARE(record.addedAt, qint64(1000) * (n - 1));
+        QCOMPARE(record.cellId, quint32(n - 1));
+        QCOMPARE(QString(record.number), QString::number(n - 1));
+        reader.close();
+
+        // opening the file again appends to it
+        writer.close();
+        QVERIFY(!writer.append(makeRecord(0)));
+        QVERIFY(writer.open(fileName));
+        QCOMPARE(writer.count(), qint64(n));
+        QVERIFY(writer.append(makeRecord(n)));
+        writer.close();
+
+        QVERIFY(reader.open(fileName));
+        QCOMPARE(reader.count(), qint64(n + 1));
+        QCOMPARE(reader.at(n).answerTime, qint32(n));
+        QCOMPARE(reader.at(0).direction, quint8(OfonoCdrRecord::Outgoing));
+    }
+
+    void testBadFile()
+    {
+        QTemporaryDir dir;
+        QString fileName = dir.path() + "/bogus";
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(64, 'x'));
+        file.close();
+
+        OfonoCdrWriter writer(0);
+        QVERIFY(!writer.open(fileName));
+        QVERIFY(!writer.isOpen());
+        OfonoCdrReader reader;
+        QVERIFY(!reader.open(fileName));
+        QVERIFY(!reader.open(dir.path() + "/missing"));
+    }
+
+    void testStrings()
+    {
+        QCOMPARE(OfonoCdrWriter::technologyFromString("lte"), OfonoCdrRecord::Lte);
+        QCOMPARE(OfonoCdrWriter::technologyFromString("gprs"), OfonoCdrRecord::Gprs);
+        QCOMPARE(OfonoCdrWriter::technologyFromString("hsdpa"), OfonoCdrRecord::Hsdpa);
+        QCOMPARE(OfonoCdrWriter::technologyFromString("hsupa"), OfonoCdrRecord::Hsupa);
+        QCOMPARE(OfonoCdrWriter::technologyFromString(""), OfonoCdrRecord::UnknownTechnology);
+        QCOMPARE(OfonoCdrWriter::disconnectReasonFromString("remote"), OfonoCdrRecord::RemoteReason);
+    }
+};
+
+QTEST_MAIN(TestOfonoCdrWriter)
+#include "test_ofonocdrwriter.moc"
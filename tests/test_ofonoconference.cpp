@@ -0,0 +1,112 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonovoicecallmanager.h>
+#include <ofonovoicecall.h>
+#include <ofonoconference.h>
+#include <QtDebug>
+
+class TestOfonoConference : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        m = new OfonoVoiceCallManager(OfonoModem::ManualSelect, "/phonesim", this);
+        QCOMPARE(m->modem()->isValid(), true);
+        if (!m->modem()->powered()) {
+            m->modem()->setPowered(true);
+            QTest::qWait(5000);
+        }
+        if (!m->modem()->online()) {
+            m->modem()->setOnline(true);
+            QTest::qWait(5000);
+        }
+        QCOMPARE(m->isValid(), true);
+    }
+
+    void testOfonoConference()
+    {
+        bool success = false;
+        OfonoConference conference(m);
+        QCOMPARE(conference.isActive(), false);
+        QCOMPARE(conference.joinLatency(), qint64(-1));
+
+        QSignalSpy dspy(m, SIGNAL(callAdded(QString, QVariantMap)));
+        QSignalSpy joined(&conference, SIGNAL(memberJoined(QString)));
+        QSignalSpy left(&conference, SIGNAL(memberLeft(QString)));
+        QSignalSpy created(&conference, SIGNAL(createComplete(bool, QStringList)));
+        QSignalSpy splitted(&conference, SIGNAL(splitComplete(bool, QStringList)));
+
+        // an active call and a held one
+        m->dial("123", "", success);
+        QCOMPARE(success, true);
+        qDebug() << "Please find a call in 'Dialing' state in phonesim window and press 'Active' button";
+        QTest::qWait(15000);
+        m->dial("199", "", success);
+        QTest::qWait(8000);
+        QCOMPARE(dspy.count(), 2);
+        QString c1 = dspy.takeFirst().at(0).toString();
+        m->holdAndAnswer();
+        QTest::qWait(4000);
+
+        // create does not block
+        conference.create();
+        QCOMPARE(created.count(), 0);
+        QTest::qWait(4000);
+        QCOMPARE(created.count(), 1);
+        QCOMPARE(created.takeFirst().at(0).toBool(), true);
+        QCOMPARE(joined.count(), 2);
+        QCOMPARE(conference.count(), 2);
+        QVERIFY(conference.contains(c1));
+        QVERIFY(conference.joinLatency() >= 0);
+
+        conference.split(c1);
+        QTest::qWait(4000);
+        QCOMPARE(splitted.count(), 1);
+        QCOMPARE(splitted.takeFirst().at(0).toBool(), true);
+        QVERIFY(left.count() > 0);
+        QVERIFY(!conference.contains(c1));
+        QVERIFY(conference.leaveLatency() >= 0);
+
+        m->hangupAll();
+        QTest::qWait(5000);
+        QCOMPARE(conference.isActive(), false);
+        QVERIFY(m->callObjects().isEmpty());
+    }
+
+    void cleanupTestCase()
+    {
+
+    }
+
+private:
+    OfonoVoiceCallManager *m;
+};
+
+QTEST_MAIN(TestOfonoConference)
+#include "test_ofonoconference.moc"
@@ -0,0 +1,86 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonoconnection.h>
+#include <ofonomodemmanager.h>
+#include <ofonomodem.h>
+
+#include <QtDebug>
+
+class TestOfonoConnection : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testDefault()
+    {
+        OfonoConnection c;
+        QCOMPARE(c.service(), QString("org.ofono"));
+        QCOMPARE(c.bus().name(), QDBusConnection::systemBus().name());
+        QVERIFY(OfonoConnection::current() == c);
+        QVERIFY(OfonoConnection::defaultConnection() == c);
+    }
+
+    void testScope()
+    {
+        OfonoConnection system;
+        OfonoConnection session(QDBusConnection::sessionBus(), "org.ofono.mock");
+        OfonoConnection other(QDBusConnection::sessionBus(), "org.ofono.other");
+        QVERIFY(session != system);
+        {
+            OfonoConnectionScope outer(session);
+            QVERIFY(OfonoConnection::current() == session);
+            {
+                OfonoConnectionScope inner(other);
+                QVERIFY(OfonoConnection::current() == other);
+            }
+            QVERIFY(OfonoConnection::current() == session);
+
+            OfonoModemManager mm;
+            QVERIFY(mm.connection() == session);
+            // no oFono on this service
+            QCOMPARE(mm.modems().count(), 0);
+        }
+        QVERIFY(OfonoConnection::current() == system);
+
+        OfonoModem m(OfonoModem::ManualSelect, "/phonesim");
+        QVERIFY(m.connection() == system);
+        QVERIFY(m.isValid());
+    }
+
+    void testSetDefault()
+    {
+        OfonoConnection session(QDBusConnection::sessionBus(), "org.ofono.mock");
+        OfonoConnection::setDefaultConnection(session);
+        QVERIFY(OfonoConnection::current() == session);
+        OfonoConnection::setDefaultConnection(OfonoConnection());
+        QVERIFY(OfonoConnection::current() == OfonoConnection());
+    }
+};
+
+QTEST_MAIN(TestOfonoConnection)
+#include "test_ofonoconnection.moc"
@@ -123,6 +123,43 @@ private slots:
 
     }
 
+    void testOfonoConnmanContextCopy()
+    {
+        bool success = false;
+        QSignalSpy conadd(m, SIGNAL(contextAdded(const QString&)));
+        m->addContext("internet", success);
+        QTest::qWait(1000);
+        QCOMPARE(success, true);
+        QCOMPARE(conadd.count(), 1);
+        QString contextid = conadd.takeFirst().at(0).toString();
+
+        OfonoConnmanContext context(contextid);
+        OfonoConnmanContext copy(context);
+
+        // the copy shares the properties of the original and fetches nothing
+        QVERIFY(copy.isSharedWith(context));
+        QVERIFY(copy == context);
+        QCOMPARE(copy.snapshot().version(), context.snapshot().version());
+        QCOMPARE(copy.name(), context.name());
+
+        QSignalSpy name(&context, SIGNAL(nameChanged(const QString&)));
+        QSignalSpy copyname(&copy, SIGNAL(nameChanged(const QString&)));
+        copy.setName("kopio");
+        QTest::qWait(2000);
+        QCOMPARE(name.count(), 1);
+        QCOMPARE(copyname.count(), 1);
+        QCOMPARE(context.name(), QString("kopio"));
+
+        OfonoConnmanContext moved(std::move(copy));
+        QVERIFY(moved.isSharedWith(context));
+        QVERIFY(!copy.isSharedWith(context));
+        copy = context;
+        QVERIFY(copy.isSharedWith(context));
+
+        m->removeContext(contextid);
+        QTest::qWait(2000);
+    }
+
     void cleanupTestCase()
     {
 
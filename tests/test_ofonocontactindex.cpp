@@ -0,0 +1,130 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonocontactindex.h>
+
+#include <QtDebug>
+
+static const char vcards[] =
+    "BEGIN:VCARD\r\n"
+    "VERSION:3.0\r\n"
+    "FN:Alice Example\r\n"
+    "TEL;TYPE=CELL:+358 40 123 4567\r\n"
+    "TEL;TYPE=HOME:555-0100\r\n"
+    "END:VCARD\r\n"
+    "BEGIN:VCARD\r\n"
+    "VERSION:3.0\r\n"
+    "N:Builder;Bob;;;\r\n"
+    "item1.TEL:00 44 20 7946 0000\r\n"
+    "END:VCARD\r\n"
+    "BEGIN:VCARD\r\n"
+    "VERSION:3.0\r\n"
+    "FN:Carol\\, the\r\n"
+    "  Long Name\r\n"
+    "TEL:+1 202 123 4567\r\n"
+    "END:VCARD\r\n";
+
+class TestOfonoContactIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testLoad()
+    {
+        OfonoContactIndex index(0);
+        QSignalSpy loaded(&index, SIGNAL(loaded(int)));
+
+        index.load(vcards);
+        QVERIFY(index.isLoading());
+        QCOMPARE(index.count(), 0);
+        QTest::qWait(100);
+        QCOMPARE(loaded.count(), 1);
+        QCOMPARE(loaded.takeFirst().at(0).toInt(), 4);
+        QVERIFY(!index.isLoading());
+
+        QCOMPARE(index.lookup("+358401234567"), QString("Alice Example"));
+        QCOMPARE(index.lookup("5550100"), QString("Alice Example"));
+        QCOMPARE(index.lookup("+442079460000"), QString("Bob Builder"));
+        QCOMPARE(index.lookup("+12021234567"), QString("Carol, the Long Name"));
+        // national form of an international number
+        QCOMPARE(index.lookup("020 7946 0000"), QString("Bob Builder"));
+        QCOMPARE(index.lookup("040 765 4321"), QString());
+        QCOMPARE(index.lookup(""), QString());
+
+        // the last seven digits of Alice and Carol are the same
+        QCOMPARE(index.lookup("040 123 4567"), QString());
+        index.insert("+358 40 765 4321", "Dave");
+        QCOMPARE(index.lookup("040 765 4321"), QString("Dave"));
+    }
+
+    void testAmbiguousSuffix()
+    {
+        OfonoContactIndex index(0);
+        index.insert("+358401234567", "Alice");
+        index.insert("+12021234567", "Carol");
+        QCOMPARE(index.lookup("0401234567"), QString());
+        QCOMPARE(index.lookup("+358401234567"), QString("Alice"));
+        QCOMPARE(index.lookup("+12021234567"), QString("Carol"));
+    }
+
+    void testReload()
+    {
+        OfonoContactIndex index(0);
+        index.insert("123456789", "Old");
+        QCOMPARE(index.lookup("123456789"), QString("Old"));
+
+        // the old index answers until the new one is complete
+        index.load("BEGIN:VCARD\nFN:New\nTEL:123456789\nEND:VCARD\n");
+        QCOMPARE(index.lookup("123456789"), QString("Old"));
+        QTest::qWait(100);
+        QCOMPARE(index.lookup("123456789"), QString("New"));
+        QCOMPARE(index.count(), 1);
+
+        index.clear();
+        QCOMPARE(index.lookup("123456789"), QString());
+    }
+
+    void testLargeLoad()
+    {
+        QString text;
+        for (int i = 0; i < 1000; i++) {
+            text += QString("BEGIN:VCARD\nFN:Contact %1\nTEL:+35840%2\nEND:VCARD\n")
+                    .arg(i).arg(1000000 + i);
+        }
+        OfonoContactIndex index(0);
+        QSignalSpy loaded(&index, SIGNAL(loaded(int)));
+        index.load(text);
+        QTest::qWait(1000);
+        QCOMPARE(loaded.count(), 1);
+        QCOMPARE(index.count(), 1000);
+        QCOMPARE(index.lookup("+358401000999"), QString("Contact 999"));
+        QCOMPARE(index.lookup("0401000500"), QString("Contact 500"));
+    }
+};
+
+QTEST_MAIN(TestOfonoContactIndex)
+#include "test_ofonocontactindex.moc"
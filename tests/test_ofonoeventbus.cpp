@@ -0,0 +1,183 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonoeventbus.h>
+#include <ofononetworkregistration.h>
+
+#include <QtDebug>
+
+class TestOfonoEventBus : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        bus = OfonoEventBus::instance();
+        bus->setEnabled(true);
+        bus->setCapacity(4096);
+        bus->takeEvents();
+    }
+
+    void cleanup()
+    {
+        bus->setEnabled(false);
+        bus->takeEvents();
+    }
+
+    void testPropertyIds()
+    {
+        quint16 id = OfonoEventBus::propertyId("Strength");
+        QVERIFY(id > 0);
+        QCOMPARE(OfonoEventBus::propertyId("Strength"), id);
+        QCOMPARE(OfonoEventBus::propertyName(id), QString("Strength"));
+        QCOMPARE(OfonoEventBus::propertyName(0), QString());
+        QCOMPARE(OfonoEventBus::interfaceId("org.ofono.VoiceCall"), OfonoEvent::VoiceCall);
+        QCOMPARE(OfonoEventBus::interfaceId("org.example.Foo"), OfonoEvent::UnknownInterface);
+    }
+
+    void testPropertyDedup()
+    {
+        QSignalSpy available(bus, SIGNAL(eventsAvailable()));
+
+        bus->publishProperty("/phonesim", "org.ofono.NetworkRegistration", "Strength", 10);
+        bus->publishProperty("/phonesim", "org.ofono.NetworkRegistration", "Strength", 10);
+        bus->publishProperty("/phonesim", "org.ofono.NetworkRegistration", "Strength", 20);
+        bus->publishProperty("/phonesim/operator/23402", "org.ofono.NetworkOperator", "Status", "current");
+        QCOMPARE(available.count(), 1);
+        QCOMPARE(bus->pendingCount(), 3);
+
+        QVector<OfonoEvent> events = bus->takeEvents();
+        QCOMPARE(events.count(), 3);
+        QCOMPARE(int(events[0].type), int(OfonoEvent::PropertyChanged));
+        QCOMPARE(int(events[0].iface), int(OfonoEvent::NetworkRegistration));
+        QCOMPARE(OfonoEventBus::propertyName(events[0].property), QString("Strength"));
+        QCOMPARE(events[1].value.toInt(), 20);
+        QVERIFY(events[1].timestamp >= events[0].timestamp);
+        QCOMPARE(events[2].modemPath, QString("/phonesim"));
+        QCOMPARE(bus->pendingCount(), 0);
+    }
+
+    void testObjectDedup()
+    {
+        bus->publish(OfonoEvent::ModemAdded, "/phonesim", "org.ofono.Modem");
+        bus->publish(OfonoEvent::ModemAdded, "/phonesim", "org.ofono.Modem");
+        bus->publish(OfonoEvent::CallAdded, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->publish(OfonoEvent::CallRemoved, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->publish(OfonoEvent::CallRemoved, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->publishProperty("/phonesim", "org.ofono.Modem", "Online", true);
+        bus->publish(OfonoEvent::ModemRemoved, "/phonesim", "org.ofono.Modem");
+
+        QVector<OfonoEvent> events = bus->takeEvents();
+        QCOMPARE(events.count(), 5);
+        QCOMPARE(int(events[1].type), int(OfonoEvent::CallAdded));
+        QCOMPARE(events[1].modemPath, QString("/phonesim"));
+        QCOMPARE(int(events[4].type), int(OfonoEvent::ModemRemoved));
+
+        // the removed modem's state is forgotten, so the same value is new again
+        bus->publishProperty("/phonesim", "org.ofono.Modem", "Online", true);
+        QCOMPARE(bus->pendingCount(), 1);
+        bus->takeEvents();
+
+        // so is a removed call's, as its path is reused by the next call
+        bus->publish(OfonoEvent::CallAdded, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->publishProperty("/phonesim/voicecall01", "org.ofono.VoiceCall", "State", "active");
+        bus->publish(OfonoEvent::CallRemoved, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->publish(OfonoEvent::CallAdded, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->publishProperty("/phonesim/voicecall01", "org.ofono.VoiceCall", "State", "active");
+        QCOMPARE(bus->pendingCount(), 5);
+        bus->publish(OfonoEvent::CallRemoved, "/phonesim/voicecall01", "org.ofono.VoiceCall");
+        bus->takeEvents();
+
+        // and a removed message's
+        bus->publish(OfonoEvent::MessageAdded, "/phonesim/message01", "org.ofono.Message");
+        bus->publishProperty("/phonesim/message01", "org.ofono.Message", "State", "pending");
+        bus->publish(OfonoEvent::MessageRemoved, "/phonesim/message01", "org.ofono.Message");
+        bus->publish(OfonoEvent::MessageRemoved, "/phonesim/message01", "org.ofono.Message");
+        bus->publishProperty("/phonesim/message01", "org.ofono.Message", "State", "pending");
+        events = bus->takeEvents();
+        QCOMPARE(events.count(), 4);
+        QCOMPARE(events[0].modemPath, QString("/phonesim"));
+        QCOMPARE(int(events[2].type), int(OfonoEvent::MessageRemoved));
+    }
+
+    void testIncomingMessages()
+    {
+        // two messages with the same sender and text are two messages
+        QVariantList message = QVariantList() << "hello" << "+123";
+        bus->publish(OfonoEvent::MessageIncoming, "/phonesim", "org.ofono.MessageManager", message);
+        bus->publish(OfonoEvent::MessageIncoming, "/phonesim", "org.ofono.MessageManager", message);
+        QCOMPARE(bus->takeEvents().count(), 2);
+    }
+
+    void testCapacity()
+    {
+        bus->setCapacity(2);
+        quint64 dropped = bus->droppedCount();
+        for (int i = 0; i < 5; i++)
+            bus->publishProperty("/phonesim", "org.ofono.CallMeter", "CallMeter", i);
+        QCOMPARE(bus->droppedCount() - dropped, quint64(3));
+
+        QVector<OfonoEvent> events = bus->takeEvents(1);
+        QCOMPARE(events.count(), 1);
+        QCOMPARE(events[0].value.toInt(), 3);
+        QCOMPARE(bus->pendingCount(), 1);
+    }
+
+    void testDisabled()
+    {
+        bus->setEnabled(false);
+        bus->publishProperty("/phonesim", "org.ofono.CallMeter", "CallMeter", 100);
+        QCOMPARE(bus->pendingCount(), 0);
+    }
+
+    void testNetworkRegistration()
+    {
+        OfonoNetworkRegistration *n = new OfonoNetworkRegistration(OfonoModem::ManualSelect, "/phonesim", this);
+        QVERIFY(n->isValid());
+
+        // two wrappers for the same interface publish its properties once
+        OfonoNetworkRegistration *n2 = new OfonoNetworkRegistration(OfonoModem::ManualSelect, "/phonesim", this);
+        QVector<OfonoEvent> events = bus->takeEvents();
+        quint16 status = OfonoEventBus::propertyId("Status");
+        int count = 0;
+        foreach (const OfonoEvent &event, events) {
+            if (event.iface == OfonoEvent::NetworkRegistration && event.property == status) {
+                QCOMPARE(event.value.toString(), n->status());
+                count++;
+            }
+        }
+        QCOMPARE(count, 1);
+        delete n2;
+        delete n;
+    }
+
+private:
+    OfonoEventBus *bus;
+};
+
+QTEST_MAIN(TestOfonoEventBus)
+#include "test_ofonoeventbus.moc"
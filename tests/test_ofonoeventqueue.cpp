@@ -0,0 +1,155 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QThread>
+
+#include <ofonoeventqueue.h>
+
+#include <QtDebug>
+
+class EventConsumer : public QThread
+{
+public:
+    EventConsumer(OfonoEventQueue *queue, QAtomicInt *done)
+        : m_queue(queue), m_done(done), m_sum(0), m_count(0) {}
+
+    qint64 sum() const {return m_sum;}
+    int count() const {return m_count;}
+
+protected:
+    void run()
+    {
+        OfonoEvent event;
+        for (;;) {
+            if (m_queue->pop(event)) {
+                m_sum += event.value.toInt();
+                m_count++;
+            } else if (m_done->loadAcquire()) {
+                if (!m_queue->pop(event))
+                    break;
+                m_sum += event.value.toInt();
+                m_count++;
+            } else {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+private:
+    OfonoEventQueue *m_queue;
+    QAtomicInt *m_done;
+    qint64 m_sum;
+    int m_count;
+};
+
+class TestOfonoEventQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPushPop()
+    {
+        OfonoEventQueue q(5);
+        QCOMPARE(q.capacity(), 8);
+        QVERIFY(q.isEmpty());
+
+        for (int i = 0; i < 8; i++) {
+            OfonoEvent e;
+            e.value = i;
+            QVERIFY(q.push(e));
+        }
+        OfonoEvent extra;
+        QCOMPARE(q.push(extra), false);
+        QCOMPARE(q.droppedCount(), quint32(1));
+
+        OfonoEvent e;
+        QVERIFY(q.pop(e));
+        QCOMPARE(e.value.toInt(), 0);
+        QVERIFY(q.push(extra));
+
+        QVector<OfonoEvent> events;
+        QCOMPARE(q.popBatch(events, 100), 8);
+        QCOMPARE(events.first().value.toInt(), 1);
+        QCOMPARE(events.last().value.isValid(), false);
+        QVERIFY(q.isEmpty());
+        QCOMPARE(q.pop(e), false);
+    }
+
+    void testConcurrentConsumers()
+    {
+        const int total = 100000;
+        OfonoEventQueue q(256);
+        QAtomicInt done(0);
+        QList<EventConsumer *> consumers;
+        for (int i = 0; i < 4; i++) {
+            consumers << new EventConsumer(&q, &done);
+            consumers.last()->start();
+        }
+
+        qint64 expected = 0;
+        for (int i = 1; i <= total; i++) {
+            OfonoEvent e;
+            e.value = i;
+            while (!q.push(e))
+                QThread::yieldCurrentThread();
+            expected += i;
+        }
+        done.storeRelease(1);
+
+        qint64 sum = 0;
+        int count = 0;
+        foreach (EventConsumer *c, consumers) {
+            QVERIFY(c->wait(10000));
+            sum += c->sum();
+            count += c->count();
+            delete c;
+        }
+        QCOMPARE(count, total);
+        QCOMPARE(sum, expected);
+    }
+
+    void testBusDelivery()
+    {
+        OfonoEventBus *bus = OfonoEventBus::instance();
+        OfonoEventQueue q;
+        QVERIFY(!bus->isEnabled());
+
+        bus->attachQueue(&q);
+        bus->publishProperty("/phonesim", "org.ofono.CallVolume", "Muted", true);
+        bus->publishProperty("/phonesim", "org.ofono.CallVolume", "Muted", true);
+        bus->detachQueue(&q);
+        bus->publishProperty("/phonesim", "org.ofono.CallVolume", "Muted", false);
+
+        QCOMPARE(bus->pendingCount(), 0);
+        OfonoEvent e;
+        QVERIFY(q.pop(e));
+        QCOMPARE(int(e.iface), int(OfonoEvent::CallVolume));
+        QCOMPARE(e.value.toBool(), true);
+        QVERIFY(q.isEmpty());
+    }
+};
+
+QTEST_MAIN(TestOfonoEventQueue)
+#include "test_ofonoeventqueue.moc"
@@ -0,0 +1,83 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonofederatedmodemmanager.h>
+#include <ofonosimmanager.h>
+
+#include <QtDebug>
+
+class TestOfonoFederatedModemManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testModemIds()
+    {
+        QString id = OfonoFederatedModemManager::modemId("rack1", "/phonesim");
+        QCOMPARE(id, QString("rack1:/phonesim"));
+        QCOMPARE(OfonoFederatedModemManager::sourceOf(id), QString("rack1"));
+        QCOMPARE(OfonoFederatedModemManager::pathOf(id), QString("/phonesim"));
+    }
+
+    void testSources()
+    {
+        OfonoFederatedModemManager f;
+        QSignalSpy added(&f, SIGNAL(modemAdded(const QString&)));
+        QSignalSpy removed(&f, SIGNAL(modemRemoved(const QString&)));
+
+        QVERIFY(f.addSource("sim", OfonoConnection()));
+        QVERIFY(!f.addSource("sim", OfonoConnection()));
+        QVERIFY(!f.addSource("bad:name", OfonoConnection()));
+        QVERIFY(f.addSource("mock", OfonoConnection(QDBusConnection::systemBus(), "org.ofono.absent")));
+        QCOMPARE(f.sources(), QStringList() << "sim" << "mock");
+
+        QVERIFY(f.isSourceAvailable("sim"));
+        QVERIFY(!f.isSourceAvailable("mock"));
+        QVERIFY(f.modems().contains("sim:/phonesim"));
+        QCOMPARE(f.modems("mock").count(), 0);
+        QCOMPARE(added.count(), f.modems().count());
+        QCOMPARE(f.connection("mock").service(), QString("org.ofono.absent"));
+
+        // interfaces of a federated modem use the connection of its source
+        QString id = "sim:/phonesim";
+        {
+            OfonoConnectionScope scope(f.connection(OfonoFederatedModemManager::sourceOf(id)));
+            OfonoSimManager sim(OfonoModem::ManualSelect, OfonoFederatedModemManager::pathOf(id));
+            QCOMPARE(sim.modem()->path(), QString("/phonesim"));
+            QVERIFY(sim.modem()->isValid());
+        }
+
+        int count = f.modems().count();
+        f.removeSource("sim");
+        QCOMPARE(removed.count(), count);
+        QCOMPARE(f.modems().count(), 0);
+        QCOMPARE(f.sources(), QStringList() << "mock");
+    }
+};
+
+QTEST_MAIN(TestOfonoFederatedModemManager)
+#include "test_ofonofederatedmodemmanager.moc"
@@ -142,6 +142,67 @@ private slots:
         QTest::qWait(5000);
     }
 
+    void testPropertyCallback()
+    {
+        QList<bool> online;
+        int handle = oi->addPropertyCallback("Online", [&online](const QVariant &value) {
+            online << value.toBool();
+        });
+        QVERIFY(handle > 0);
+
+        oi->setProperty("Online", QVariant::fromValue(false));
+        for (int i = 0; i < 50 && online.count() == 0; i++)
+            QTest::qWait(100);
+        QCOMPARE(online.count(), 1);
+        QCOMPARE(online.takeFirst(), false);
+
+        oi->removePropertyCallback(handle);
+        oi->setProperty("Online", QVariant::fromValue(true));
+        QTest::qWait(5000);
+        QCOMPARE(online.count(), 0);
+        QCOMPARE(oi->properties()["Online"].toBool(), true);
+
+        // a callback removed by an earlier one is not invoked any more
+        int second = 0;
+        OfonoInterface *i = oi;
+        int first = oi->addPropertyCallback("Online", [i, &second](const QVariant &) {
+            i->removePropertyCallback(second);
+        });
+        second = oi->addPropertyCallback("Online", [&online](const QVariant &value) {
+            online << value.toBool();
+        });
+        oi->setProperty("Online", QVariant::fromValue(false));
+        QTest::qWait(5000);
+        QCOMPARE(online.count(), 0);
+        oi->removePropertyCallback(first);
+        oi->setProperty("Online", QVariant::fromValue(true));
+        QTest::qWait(5000);
+    }
+
+    void testSnapshot()
+    {
+        OfonoPropertySnapshot before = oi->snapshot();
+        QVERIFY(!before.isNull());
+        QCOMPARE(before.path(), QString("/phonesim"));
+        QCOMPARE(before.value("Online").toBool(), true);
+        QCOMPARE(oi->snapshot().version(), before.version());
+
+        oi->setProperty("Online", QVariant::fromValue(false));
+        for (int i = 0; i < 50 && oi->snapshot().version() == before.version(); i++)
+            QTest::qWait(100);
+
+        OfonoPropertySnapshot after = oi->snapshot();
+        QVERIFY(after.version() > before.version());
+        QCOMPARE(after.value("Online").toBool(), false);
+        // an existing snapshot never changes
+        QCOMPARE(before.value("Online").toBool(), true);
+        QCOMPARE(after.value("Manufacturer"), before.value("Manufacturer"));
+
+        oi->setProperty("Online", QVariant::fromValue(true));
+        QTest::qWait(5000);
+        QCOMPARE(OfonoPropertySnapshot().version(), quint64(0));
+    }
+
     void testSetPropertyFailed()
     {
         QSignalSpy spy_changed(oi, SIGNAL(propertyChanged(const QString &, const QVariant &)));
@@ -0,0 +1,111 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QThread>
+
+#include <ofonoiothread.h>
+#include <ofonomodem.h>
+
+#include <QtDebug>
+
+class OnlineReader : public QThread
+{
+public:
+    OnlineReader(OfonoModem *modem) : m_modem(modem), m_online(true) {}
+
+    bool online() const {return m_online;}
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < 1000; i++)
+            m_online = m_modem->online();
+    }
+
+private:
+    OfonoModem *m_modem;
+    bool m_online;
+};
+
+class TestOfonoIoThread : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        OfonoIoThread::setEnabled(true);
+        QVERIFY(OfonoIoThread::isEnabled());
+        QVERIFY(OfonoIoThread::thread() != 0);
+
+        m = new OfonoModem(OfonoModem::ManualSelect, "/phonesim", this);
+        QVERIFY(m->isValid());
+        if (!m->powered()) {
+            m->setPowered(true);
+            QTest::qWait(5000);
+        }
+        if (!m->online()) {
+            m->setOnline(true);
+            QTest::qWait(5000);
+        }
+        QVERIFY(m->online());
+    }
+
+    void testUpdateWhileBusy()
+    {
+        QSignalSpy online(m, SIGNAL(onlineChanged(bool)));
+
+        m->setOnline(false);
+        // keep this thread busy; the cache is updated on the I/O thread
+        QThread::msleep(5000);
+        QCOMPARE(m->online(), false);
+        QCOMPARE(online.count(), 0);
+
+        OnlineReader reader(m);
+        reader.start();
+        QVERIFY(reader.wait(5000));
+        QCOMPARE(reader.online(), false);
+
+        QTest::qWait(1000);
+        QCOMPARE(online.count(), 1);
+        QCOMPARE(online.takeFirst().at(0).toBool(), false);
+
+        m->setOnline(true);
+        QTest::qWait(5000);
+        QCOMPARE(m->online(), true);
+    }
+
+    void cleanupTestCase()
+    {
+        OfonoIoThread::setEnabled(false);
+    }
+
+private:
+    OfonoModem *m;
+};
+
+QTEST_MAIN(TestOfonoIoThread)
+#include "test_ofonoiothread.moc"
@@ -236,6 +236,79 @@ private slots:
 
     }    
 
+    void testOfonoModemInterfaceBits()
+    {
+        quint64 bits = 0;
+        foreach (QString ifname, mm->interfaces()) {
+            QVERIFY(mm->hasInterface(ifname));
+            int bit = OfonoModem::interfaceBit(ifname);
+            QVERIFY(bit >= 0);
+            QCOMPARE(OfonoModem::interfaceName(bit), ifname);
+            bits |= Q_UINT64_C(1) << bit;
+        }
+        QCOMPARE(mm->interfaceBits(), bits);
+        QVERIFY(!mm->hasInterface("org.example.Unknown"));
+        // looking up a name does not use up a bit
+        QCOMPARE(OfonoModem::interfaceBit("org.example.Unknown"), -1);
+        QCOMPARE(OfonoModem::featureBit("example"), -1);
+        QVERIFY(mm->hasFeature("net"));
+        QVERIFY(!mm->hasFeature("example"));
+
+        QSignalSpy appeared(mm, SIGNAL(interfaceAppeared(const QString&)));
+        QSignalSpy disappeared(mm, SIGNAL(interfaceDisappeared(const QString&)));
+        QSignalSpy bitsChanged(mm, SIGNAL(interfaceBitsChanged(quint64, quint64)));
+
+        mm->setOnline(false);
+        QTest::qWait(5000);
+        QVERIFY(!mm->hasInterface("org.ofono.NetworkRegistration"));
+        QVERIFY(!mm->hasFeature("net"));
+        QVERIFY(bitsChanged.count() > 0);
+        QVERIFY(disappeared.count() > 0);
+        QStringList gone;
+        while (disappeared.count() > 0)
+            gone << disappeared.takeFirst().at(0).toString();
+        QVERIFY(gone.contains("org.ofono.NetworkRegistration"));
+
+        mm->setOnline(true);
+        QTest::qWait(5000);
+        QVERIFY(mm->hasInterface("org.ofono.NetworkRegistration"));
+        QStringList back;
+        while (appeared.count() > 0)
+            back << appeared.takeFirst().at(0).toString();
+        QVERIFY(back.contains("org.ofono.NetworkRegistration"));
+    }
+
+    void testOfonoModemSelectionPolicy()
+    {
+        OfonoModem powered(OfonoModem::FirstPoweredPolicy);
+        QCOMPARE(powered.selectionPolicy(), OfonoModem::FirstPoweredPolicy);
+        QVERIFY(powered.isValid());
+        QVERIFY(powered.powered());
+        QCOMPARE(powered.failoverLatency(), qint64(-1));
+
+        OfonoModem custom(OfonoModem::AutomaticSelect, QString());
+        QSignalSpy pathChanged(&custom, SIGNAL(pathChanged(QString)));
+        QSignalSpy validity(&custom, SIGNAL(validityChanged(bool)));
+        custom.setSelector([](const QStringList &) { return QString("/nonexistent"); });
+        QCOMPARE(custom.selectionPolicy(), OfonoModem::CustomPolicy);
+        custom.reselect();
+        QCOMPARE(custom.path(), QString("/"));
+        QVERIFY(!custom.isValid());
+        QCOMPARE(pathChanged.count(), 1);
+        QCOMPARE(validity.count(), 1);
+
+        custom.setSelector([](const QStringList &modems) {
+            return modems.contains("/phonesim") ? QString("/phonesim") : QString();
+        });
+        custom.reselect();
+        QCOMPARE(custom.path(), QString("/phonesim"));
+        QVERIFY(custom.isValid());
+        // the modem properties arrive without blocking
+        for (int i = 0; i < 50 && custom.manufacturer().isEmpty(); i++)
+            QTest::qWait(100);
+        QCOMPARE(custom.manufacturer(), QString("MeeGo"));
+    }
+
     void cleanupTestCase()
     {
 
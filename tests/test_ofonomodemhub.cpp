@@ -0,0 +1,111 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonomodemhub.h>
+#include <ofonomodem.h>
+#include <ofonosimmanager.h>
+#include <ofononetworkregistration.h>
+#include <ofonovoicecallmanager.h>
+
+#include <QtDebug>
+
+class TestOfonoModemHub : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        h = new OfonoModemHub(OfonoModem::ManualSelect, "/phonesim", this);
+        QVERIFY(h->modem()->isValid());
+        if (!h->modem()->powered()) {
+            h->modem()->setPowered(true);
+            QTest::qWait(5000);
+        }
+        if (!h->modem()->online()) {
+            h->modem()->setOnline(true);
+            QTest::qWait(5000);
+        }
+    }
+
+    void testLazyLoad()
+    {
+        QSignalSpy loaded(h, SIGNAL(interfaceLoaded(const QString&)));
+        QVERIFY(h->loadedInterfaces().isEmpty());
+
+        OfonoSimManager *s = h->simManager();
+        QVERIFY(s != 0);
+        QVERIFY(s->isValid());
+        QCOMPARE(s->modem(), h->modem());
+        QVERIFY(h->isLoaded("org.ofono.SimManager"));
+        QCOMPARE(h->simManager(), s);
+        QCOMPARE(loaded.count(), 1);
+        QCOMPARE(loaded.takeFirst().at(0).toString(), QString("org.ofono.SimManager"));
+
+        OfonoVoiceCallManager *v = h->voiceCallManager();
+        QVERIFY(v != 0);
+        QCOMPARE(v->modem(), h->modem());
+        QCOMPARE(h->loadedInterfaces().count(), 2);
+    }
+
+    void testUnload()
+    {
+        QPointer<OfonoNetworkRegistration> n = h->networkRegistration();
+        QVERIFY(!n.isNull());
+        QVERIFY(n->isValid());
+
+        QSignalSpy unloaded(h, SIGNAL(interfaceUnloaded(const QString&)));
+        h->modem()->setOnline(false);
+        QTest::qWait(5000);
+        QVERIFY(!h->isLoaded("org.ofono.NetworkRegistration"));
+        QVERIFY(n.isNull());
+        QStringList names;
+        while (unloaded.count() > 0)
+            names << unloaded.takeFirst().at(0).toString();
+        QVERIFY(names.contains("org.ofono.NetworkRegistration"));
+        QVERIFY(h->networkRegistration() == 0);
+        // the SIM stays around while the modem is offline
+        QVERIFY(h->isLoaded("org.ofono.SimManager"));
+
+        h->modem()->setOnline(true);
+        QTest::qWait(5000);
+        QVERIFY(h->networkRegistration() != 0);
+        QVERIFY(h->networkRegistration()->isValid());
+    }
+
+    void cleanupTestCase()
+    {
+
+    }
+
+
+private:
+    OfonoModemHub *h;
+};
+
+QTEST_MAIN(TestOfonoModemHub)
+#include "test_ofonomodemhub.moc"
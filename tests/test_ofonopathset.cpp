@@ -0,0 +1,104 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonopathset.h>
+
+#include <QtDebug>
+
+class TestOfonoPathSet : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testInsertRemove()
+    {
+        OfonoPathSet s;
+        QVERIFY(s.isEmpty());
+        QVERIFY(s.insert("/a"));
+        QVERIFY(s.insert("/b"));
+        QVERIFY(s.insert("/c"));
+        QVERIFY(!s.insert("/b"));
+        QVERIFY(!s.insert(QString()));
+        QCOMPARE(s.count(), 3);
+        QVERIFY(s.contains("/b"));
+        QCOMPARE(s.toList(), QStringList() << "/a" << "/b" << "/c");
+
+        QVERIFY(s.remove("/b"));
+        QVERIFY(!s.remove("/b"));
+        QVERIFY(!s.contains("/b"));
+        QCOMPARE(s.count(), 2);
+        QCOMPARE(s.toList(), QStringList() << "/a" << "/c");
+
+        // a path that comes back goes to the end
+        QVERIFY(s.insert("/b"));
+        QCOMPARE(s.toList(), QStringList() << "/a" << "/c" << "/b");
+
+        s.clear();
+        QVERIFY(s.isEmpty());
+        QVERIFY(s.toList().isEmpty());
+    }
+
+    void testFromList()
+    {
+        OfonoPathSet s(QStringList() << "/x" << "/y" << "/x");
+        QCOMPARE(s.count(), 2);
+        QCOMPARE(s.toList(), QStringList() << "/x" << "/y");
+    }
+
+    void testCompaction()
+    {
+        OfonoPathSet s;
+        QStringList expected;
+        for (int i = 0; i < 1000; i++)
+            s.insert(QString("/modem%1").arg(i));
+        for (int i = 0; i < 1000; i++) {
+            if (i % 3)
+                QVERIFY(s.remove(QString("/modem%1").arg(i)));
+            else
+                expected << QString("/modem%1").arg(i);
+        }
+        QCOMPARE(s.count(), expected.count());
+        QCOMPARE(s.toList(), expected);
+        foreach (QString path, expected)
+            QVERIFY(s.contains(path));
+        QVERIFY(!s.contains("/modem1"));
+    }
+
+    void testListIsShared()
+    {
+        OfonoPathSet s(QStringList() << "/a" << "/b");
+        QStringList first = s.toList();
+        // an unchanged set hands out the same list
+        QVERIFY(first.constBegin() == s.toList().constBegin());
+        s.remove("/a");
+        QCOMPARE(first, QStringList() << "/a" << "/b");
+        QCOMPARE(s.toList(), QStringList() << "/b");
+    }
+};
+
+QTEST_MAIN(TestOfonoPathSet)
+#include "test_ofonopathset.moc"
@@ -0,0 +1,192 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonopropertycache.h>
+#include <ofonomodemmanager.h>
+#include <ofonomodem.h>
+#include <ofononetworkregistration.h>
+#include <ofonosimmanager.h>
+
+#include <QtDebug>
+
+class TestOfonoPropertyCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        c = OfonoPropertyCache::forConnection(OfonoConnection());
+        m = new OfonoModem(OfonoModem::ManualSelect, "/phonesim", this);
+        QVERIFY(m->isValid());
+        if (!m->powered()) {
+            m->setPowered(true);
+            QTest::qWait(5000);
+        }
+        if (!m->online()) {
+            m->setOnline(true);
+            QTest::qWait(5000);
+        }
+    }
+
+    void testSeed()
+    {
+        // the modem manager of the modem seeds the modem properties
+        QVERIFY(c->contains("/phonesim", "org.ofono.Modem"));
+        QVariantMap properties;
+        QVERIFY(c->fetch("/phonesim", "org.ofono.Modem", properties));
+        QCOMPARE(properties["Online"].toBool(), true);
+        QVERIFY(!c->fetch("/phonesim", "org.example.Unknown", properties));
+    }
+
+    void testWarmUp()
+    {
+        QSignalSpy warmed(c, SIGNAL(warmedUp(const QString&)));
+        c->warmUp("/phonesim");
+        QVERIFY(c->isWarmingUp("/phonesim"));
+
+        // constructing while the calls are in flight waits for the reply
+        OfonoNetworkRegistration n(OfonoModem::ManualSelect, "/phonesim");
+        QVERIFY(n.isValid());
+        QVERIFY(!n.status().isEmpty());
+
+        for (int i = 0; i < 100 && warmed.count() == 0; i++)
+            QTest::qWait(100);
+        QCOMPARE(warmed.count(), 1);
+        QCOMPARE(warmed.takeFirst().at(0).toString(), QString("/phonesim"));
+        QVERIFY(!c->isWarmingUp("/phonesim"));
+        QVERIFY(c->contains("/phonesim", "org.ofono.NetworkRegistration"));
+        QVERIFY(c->contains("/phonesim", "org.ofono.SimManager"));
+
+        OfonoSimManager s(OfonoModem::ManualSelect, "/phonesim");
+        QVariantMap properties;
+        QVERIFY(c->fetch("/phonesim", "org.ofono.SimManager", properties));
+        QCOMPARE(s.present(), properties["Present"].toBool());
+    }
+
+    void testFailedFetch()
+    {
+        c->forget("/phonesim");
+        OfonoModemManager mm;
+        QVERIFY(c->contains("/phonesim", "org.ofono.Modem"));
+        QSignalSpy warmed(c, SIGNAL(warmedUp(const QString&)));
+        c->warmUp("/phonesim");
+
+        // the phonebook has no properties, so its GetProperties call fails
+        QVariantMap properties;
+        QVERIFY(!c->fetch("/phonesim", "org.ofono.Phonebook", properties));
+        for (int i = 0; i < 100 && warmed.count() == 0; i++)
+            QTest::qWait(100);
+        QCOMPARE(warmed.count(), 1);
+
+        // the modem entry is still kept up to date
+        m->setOnline(false);
+        QTest::qWait(5000);
+        QVERIFY(c->fetch("/phonesim", "org.ofono.Modem", properties));
+        QCOMPARE(properties["Online"].toBool(), false);
+        m->setOnline(true);
+        QTest::qWait(5000);
+        QVERIFY(c->fetch("/phonesim", "org.ofono.Modem", properties));
+        QCOMPARE(properties["Online"].toBool(), true);
+    }
+
+    void testLiveUpdate()
+    {
+        m->setOnline(false);
+        QTest::qWait(5000);
+        QVariantMap properties;
+        QVERIFY(c->fetch("/phonesim", "org.ofono.Modem", properties));
+        QCOMPARE(properties["Online"].toBool(), false);
+        // interfaces that have disappeared are dropped
+        QVERIFY(!c->contains("/phonesim", "org.ofono.NetworkRegistration"));
+
+        m->setOnline(true);
+        QTest::qWait(5000);
+    }
+
+    void testSaveLoad()
+    {
+        QString fileName = QDir::tempPath() + "/test_ofonopropertycache.cache";
+        QVERIFY(!c->load(fileName + ".missing"));
+        QVERIFY(c->contains("/phonesim", "org.ofono.SimManager"));
+        QVERIFY(c->save(fileName));
+
+        // loaded entries are served at once and reconciled in the background
+        c->forget("/phonesim");
+        QSignalSpy finished(c, SIGNAL(reconcileFinished()));
+        QVERIFY(c->load(fileName));
+        QVERIFY(c->isReconciling());
+        QVERIFY(c->isStale("/phonesim", "org.ofono.SimManager"));
+        OfonoSimManager s(OfonoModem::ManualSelect, "/phonesim");
+        QVERIFY(s.isStale());
+        QVERIFY(s.present());
+
+        for (int i = 0; i < 100 && finished.count() == 0; i++)
+            QTest::qWait(100);
+        QCOMPARE(finished.count(), 1);
+        QVERIFY(!c->isReconciling());
+        QVERIFY(!c->isStale("/phonesim", "org.ofono.SimManager"));
+        QVERIFY(!s.isStale());
+
+        // an interface that has gone away meanwhile is dropped
+        c->forget("/phonesim");
+        m->setOnline(false);
+        QTest::qWait(5000);
+        QSignalSpy reconciled(c, SIGNAL(reconciled(const QString&, const QString&, const QVariantMap&)));
+        QVERIFY(c->load(fileName));
+        QVERIFY(c->isStale("/phonesim", "org.ofono.NetworkRegistration"));
+        for (int i = 0; i < 100 && c->isReconciling(); i++)
+            QTest::qWait(100);
+        QVERIFY(!c->contains("/phonesim", "org.ofono.NetworkRegistration"));
+        bool dropped = false;
+        while (reconciled.count() > 0) {
+            QList<QVariant> params = reconciled.takeFirst();
+            if (params.at(1).toString() == "org.ofono.NetworkRegistration")
+                dropped = params.at(2).toMap().isEmpty();
+        }
+        QVERIFY(dropped);
+
+        m->setOnline(true);
+        QTest::qWait(5000);
+        QFile::remove(fileName);
+    }
+
+    void testForget()
+    {
+        c->forget("/phonesim");
+        QVERIFY(!c->contains("/phonesim", "org.ofono.Modem"));
+        OfonoModemManager mm;
+        QVERIFY(c->contains("/phonesim", "org.ofono.Modem"));
+    }
+
+private:
+    OfonoPropertyCache *c;
+    OfonoModem *m;
+};
+
+QTEST_MAIN(TestOfonoPropertyCache)
+#include "test_ofonopropertycache.moc"
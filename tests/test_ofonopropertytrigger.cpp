@@ -0,0 +1,116 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonopropertytrigger.h>
+#include <ofononetworkregistration.h>
+
+#include <QtDebug>
+
+class TestOfonoPropertyTrigger : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void testCrosses()
+    {
+        OfonoPropertyTrigger t("Strength", OfonoPropertyTrigger::Crosses, 20, 5);
+
+        QCOMPARE(t.update(QVariant::fromValue(uint(30))), false);
+        QCOMPARE(t.update(QVariant::fromValue(uint(18))), false);
+        QCOMPARE(t.update(QVariant::fromValue(uint(16))), false);
+        QCOMPARE(t.update(QVariant::fromValue(uint(15))), true);
+        QCOMPARE(t.update(QVariant::fromValue(uint(19))), false);
+        QCOMPARE(t.update(QVariant::fromValue(uint(10))), false);
+        QCOMPARE(t.update(QVariant::fromValue(uint(20))), true);
+        QCOMPARE(t.update(QVariant::fromValue(uint(25))), false);
+    }
+
+    void testRisesFalls()
+    {
+        OfonoPropertyTrigger rises("Strength", OfonoPropertyTrigger::Rises, 20, 5);
+        OfonoPropertyTrigger falls("Strength", OfonoPropertyTrigger::Falls, 20, 5);
+        QList<uint> samples;
+        samples << 10 << 22 << 14 << 30 << 2;
+        int risen = 0;
+        int fallen = 0;
+
+        foreach (uint sample, samples) {
+            if (rises.update(QVariant::fromValue(sample)))
+                risen++;
+            if (falls.update(QVariant::fromValue(sample)))
+                fallen++;
+        }
+        QCOMPARE(risen, 2);
+        QCOMPARE(fallen, 2);
+    }
+
+    void testEntersLeaves()
+    {
+        OfonoPropertyTrigger leaves("Status", OfonoPropertyTrigger::Leaves, QString("registered"));
+        OfonoPropertyTrigger enters("Status", OfonoPropertyTrigger::Enters, QString("registered"));
+
+        QCOMPARE(leaves.update(QString("searching")), false);
+        QCOMPARE(enters.update(QString("searching")), false);
+        QCOMPARE(leaves.update(QString("registered")), false);
+        QCOMPARE(enters.update(QString("registered")), true);
+        QCOMPARE(leaves.update(QString("registered")), false);
+        QCOMPARE(enters.update(QString("registered")), false);
+        QCOMPARE(leaves.update(QString("roaming")), true);
+        QCOMPARE(enters.update(QString("roaming")), false);
+
+        leaves.reset();
+        QCOMPARE(leaves.update(QString("registered")), false);
+        QCOMPARE(leaves.update(QString("denied")), true);
+    }
+
+    void testChanges()
+    {
+        OfonoPropertyTrigger t("Attached", OfonoPropertyTrigger::Changes);
+
+        QCOMPARE(t.update(true), false);
+        QCOMPARE(t.update(true), false);
+        QCOMPARE(t.update(false), true);
+        QCOMPARE(t.update(false), false);
+    }
+
+    void testNetworkRegistrationTrigger()
+    {
+        OfonoNetworkRegistration *n = new OfonoNetworkRegistration(OfonoModem::ManualSelect, "/phonesim", this);
+        QSignalSpy triggered(n, SIGNAL(propertyTriggered(int, const QString&, const QVariant&)));
+
+        int id = n->addPropertyTrigger(OfonoPropertyTrigger("Status", OfonoPropertyTrigger::Leaves, n->status()));
+        QVERIFY(id > 0);
+        QTest::qWait(1000);
+        // the current value only establishes the starting state
+        QCOMPARE(triggered.count(), 0);
+        n->removePropertyTrigger(id);
+        delete n;
+    }
+};
+
+QTEST_MAIN(TestOfonoPropertyTrigger)
+#include "test_ofonopropertytrigger.moc"
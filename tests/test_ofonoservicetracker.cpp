@@ -0,0 +1,86 @@
+/*
+ * This file is part of ofono-qt
+ *
+ * Copyright (C) 2011 Nokia Corporation and/or its subsidiary(-ies).
+ *
+ * Contact: Alexander Kanavin <alex.kanavin@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+
+#include <ofonoservicetracker.h>
+#include <ofonomodemmanager.h>
+#include <ofonomodem.h>
+#include <ofononetworkregistration.h>
+
+#include <QtDebug>
+
+class TestOfonoServiceTracker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void initTestCase()
+    {
+        t = OfonoServiceTracker::forConnection(OfonoConnection());
+        QCOMPARE(t, OfonoServiceTracker::forConnection(OfonoConnection()));
+        QVERIFY(t->isServiceAvailable());
+        QVERIFY(!t->isResyncing());
+
+        n = new OfonoNetworkRegistration(OfonoModem::ManualSelect, "/phonesim", this);
+        QVERIFY(n->isValid());
+    }
+
+    void testRestart()
+    {
+        OfonoModemManager mm;
+        QStringList modems = mm.modems();
+        QVERIFY(modems.contains("/phonesim"));
+
+        QSignalSpy lost(t, SIGNAL(serviceLost()));
+        QSignalSpy returned(t, SIGNAL(serviceReturned()));
+        QSignalSpy resynced(t, SIGNAL(resynced()));
+        QSignalSpy removed(&mm, SIGNAL(modemRemoved(const QString&)));
+        QSignalSpy added(&mm, SIGNAL(modemAdded(const QString&)));
+        QSignalSpy validity(n, SIGNAL(validityChanged(bool)));
+
+        qDebug() << "Please restart ofonod and phonesim";
+        for (int i = 0; i < 600 && resynced.count() == 0; i++)
+            QTest::qWait(100);
+
+        QCOMPARE(lost.count(), 1);
+        QCOMPARE(returned.count(), 1);
+        QCOMPARE(resynced.count(), 1);
+        QCOMPARE(removed.count(), modems.count());
+        QVERIFY(added.count() > 0);
+        QVERIFY(!t->isResyncing());
+        QVERIFY(mm.modems().contains("/phonesim"));
+        QVERIFY(validity.count() > 0);
+        QCOMPARE(validity.takeFirst().at(0).toBool(), false);
+        QVERIFY(n->modem()->isValid());
+    }
+
+private:
+    OfonoServiceTracker *t;
+    OfonoNetworkRegistration *n;
+};
+
+QTEST_MAIN(TestOfonoServiceTracker)
+#include "test_ofonoservicetracker.moc"
@@ -25,6 +25,7 @@
 #include <QtCore/QObject>
 
 #include <ofonovoicecallmanager.h>
+#include <ofonovoicecall.h>
 
 #include <QtDebug>
 
@@ -59,6 +60,8 @@ private slots:
         QSignalSpy dspy(m, SIGNAL(callAdded(QString, QVariantMap)));
         QSignalSpy hupreg(m,SIGNAL(hangupAllComplete(bool)));
         QSignalSpy tonereg(m,SIGNAL(sendTonesComplete(bool)));
+        QSignalSpy toneprogress(m, SIGNAL(tonesProgress(int, int)));
+        QSignalSpy queuereg(m, SIGNAL(queueTonesComplete(bool)));
         QSignalSpy hspy(m, SIGNAL(callRemoved(QString)));
 
         m->modem()->setPowered(false);
@@ -70,6 +73,14 @@ private slots:
 
         QCOMPARE(emergencyNumbers.count(), 1);
         QVERIFY(emergencyNumbers.takeFirst().at(0).toStringList().count() > 0);
+        //Emergency number classification
+        QString emergency = m->emergencyNumbers().first();
+        QVERIFY(m->isEmergencyNumber(emergency));
+        QVERIFY(m->isEmergencyNumber(" " + emergency.left(1) + "-" + emergency.mid(1)));
+        QVERIFY(m->isEmergencyNumber("*31#" + emergency));
+        QVERIFY(m->isEmergencyNumber(emergency + ",1"));
+        QVERIFY(!m->isEmergencyNumber("123"));
+        QVERIFY(!m->isEmergencyNumber(emergency + "1"));
         //Dial testing
         QDBusObjectPath objectPath = m->dial("123","", success);
         qDebug() << "Please find a call in 'Dialing' state in phonesim window and press 'Active' button";
@@ -83,15 +94,54 @@ private slots:
         QTest::qWait(5000);
         QCOMPARE(tonereg.count(), 1);
         QCOMPARE(tonereg.takeFirst().at(0).toBool(),true);
+        // a long string is sent in chunks but completes once
+        m->sendTones("12345678901234567890");
+        QTest::qWait(10000);
+        QCOMPARE(tonereg.count(), 1);
+        QCOMPARE(tonereg.takeFirst().at(0).toBool(),true);
+        //Tone queue testing
+        m->queueTones("1234567890 p 12");
+        QCOMPARE(m->pendingTones(), 12);
+        QTest::qWait(10000);
+        QCOMPARE(queuereg.count(), 1);
+        QCOMPARE(queuereg.takeFirst().at(0).toBool(), true);
+        QCOMPARE(toneprogress.count(), 3);
+        QCOMPARE(toneprogress.at(0).at(0).toInt(), 8);
+        QCOMPARE(toneprogress.at(2).at(0).toInt(), 12);
+        QCOMPARE(toneprogress.at(2).at(1).toInt(), 12);
+        QCOMPARE(m->pendingTones(), 0);
+        // queues without tones complete too
+        m->queueTones(" ");
+        QCOMPARE(queuereg.count(), 1);
+        QCOMPARE(queuereg.takeFirst().at(0).toBool(), true);
+        m->queueTones("p");
+        QTest::qWait(3000);
+        QCOMPARE(queuereg.count(), 1);
+        QCOMPARE(queuereg.takeFirst().at(0).toBool(), true);
+        QCOMPARE(toneprogress.count(), 3);
+        // the queue is cancelled when the call goes away
+        m->queueTones("1,,,,,,2");
         QTest::qWait(5000);
         QStringList calls = m->getCalls();
         QVERIFY(calls.size()>0);
+        //call registry testing
+        QCOMPARE(m->callObjects().count(), calls.size());
+        QPointer<OfonoVoiceCall> call = m->call(calls.first());
+        QVERIFY(!call.isNull());
+        QCOMPARE(call->path(), calls.first());
+        QCOMPARE(call->lineIdentification(), QString("123"));
+        QCOMPARE(call->state(), QString("active"));
         //hangup testing
         m->hangupAll();
         QTest::qWait(5000);
         QCOMPARE(hupreg.count(), 1);
         QCOMPARE(hupreg.takeFirst().at(0).toBool(),true);
         QCOMPARE(hspy.count(), 1);
+        QCOMPARE(queuereg.count(), 1);
+        QCOMPARE(queuereg.takeFirst().at(0).toBool(), false);
+        QCOMPARE(m->pendingTones(), 0);
+        QVERIFY(call.isNull());
+        QVERIFY(m->callObjects().isEmpty());
 
     }
 
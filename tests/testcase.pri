@@ -1,4 +1,4 @@
-CONFIG += testcase
+CONFIG += testcase c++11
 QT = core testlib dbus
 INCLUDEPATH += ../lib ../
 LIBS += -L ../lib -lofono-qt
@@ -1,7 +1,21 @@
 TEMPLATE = subdirs
 SUBDIRS += test_ofonointerface.pro \
+    test_ofonopropertytrigger.pro \
+    test_ofonopathset.pro \
+    test_ofonocalltimeline.pro \
+    test_ofonocdrwriter.pro \
+    test_ofonocallhistory.pro \
+    test_ofonocallscheduler.pro \
+    test_ofonopropertycache.pro \
+    test_ofonoeventbus.pro \
+    test_ofonoeventqueue.pro \
+    test_ofonoiothread.pro \
+    test_ofonoconnection.pro \
+    test_ofonoservicetracker.pro \
     test_ofonomodemmanager.pro \
+    test_ofonofederatedmodemmanager.pro \
     test_ofonomodem.pro \
+    test_ofonomodemhub.pro \
     test_ofonomodeminterface.pro \
     test_ofonophonebook.pro \
     test_ofonomessagewaiting.pro \
@@ -21,6 +35,8 @@ SUBDIRS += test_ofonointerface.pro \
     test_ofonoconnman.pro \
     test_ofonoconnmancontext.pro \
     test_ofonomultipartycall.pro \
+    test_ofonoconference.pro \
+    test_ofonocontactindex.pro \
     test_ofonocellbroadcast.pro \
     tests.xml.pro
 # Don't forget to add your new tests to the tests.xml